@@ -3,77 +3,120 @@
 * the code to manage the simulation and make an interesting game state.
 */
 #include "headers/AStarSimulation.h"
+#include "headers/SimulationWorld.h"
 
 #pragma region Public Methods
-Simplex::AStarSimulation* Simplex::AStarSimulation::GetInstance()
-{
-	if (instance == nullptr) {
-		instance = new AStarSimulation(20, 20);
-	}
-	return instance;
-}
-
-void Simplex::AStarSimulation::ReleaseInstance()
-{
-	if (instance != nullptr) {
-		delete instance;
-		instance = nullptr;
-	}
-}
-
 void Simplex::AStarSimulation::Init()
 {
-	game_entity_manager = GameEntityManager::GetInstance();
+	world = nullptr;
+	game_entity_manager = nullptr;
 	mesh_manager = MeshManager::GetInstance();
-	system = SystemSingleton::GetInstance();
-	recalculate_a_star = true;
+	replan_scheduler = nullptr;
+	speculative_planner = nullptr;
+	navigation_mesh = nullptr;
+	line_of_sight = nullptr;
+	clearance_map = nullptr;
+	voxel_navigation = nullptr;
+	path_follower = nullptr;
+	crowd = nullptr;
+	simulation_lod = nullptr;
+	pathfinding_mode = PathfindingMode_NavigationMesh;
 	map_width = 0;
 	map_height = 0;
 	map_area = 0;
 	floor_level = -1;
+	grid_origin = vector3();
+	cell_size = 1.0f;
+	agent_size = 1;
 	tile_list = new Tile[map_area];
 
 	allowed_hidden_tiles = 0;
+	target_handle = EntityHandle();
+	finder_handle = EntityHandle();
+	target = nullptr;
+	finder = nullptr;
 	target_last_position = vector3();
-
-	traveling_from = vector3();
-	traveling_to = vector3();
+	viewer_position = vector3();
+	has_viewer = false;
+	target_last_tile = nullptr;
 }
 
 void Simplex::AStarSimulation::Destroy()
 {
 	delete[] tile_list;
 	tile_list = nullptr;
+	SafeDelete(replan_scheduler);
+	SafeDelete(speculative_planner);
+	SafeDelete(navigation_mesh);
+	SafeDelete(line_of_sight);
+	SafeDelete(clearance_map);
+	SafeDelete(voxel_navigation);
+	SafeDelete(path_follower);
+	SafeDelete(crowd);
+	SafeDelete(simulation_lod);
 }
 
-void Simplex::AStarSimulation::Update()
+void Simplex::AStarSimulation::Update(float fDelta)
 {
-	static uint sClock = system->GenClock();
-	float fDelta = system->GetDeltaTime(sClock);
-
 	CheckIfWeNeedAStarUpdate();
+	replan_scheduler->Update(fDelta);
 
-	if (recalculate_a_star) {
-		Tile* startTile = this->GetClosestTile(finder->GetPosition());
+	if (replan_scheduler->IsGranted(finder_schedule_id)) {
+		Tile* startTile = this->GetStandingTile(finder->GetPosition());
 		Tile* endTile = this->GetClosestTile(target->GetPosition());
-		if (ValidateAStarInput(startTile, endTile)) CalculateAStarBetweenTiles(startTile, endTile);
-		recalculate_a_star = false;
+		if (ValidateAStarInput(startTile, endTile)) {
+			CalculateAStarBetweenTiles(startTile, endTile);
+		} else if (!startTile || !endTile || !startTile->GetActive()) {
+			// The search was spent while someone was off the board. Ask again so the old path doesn't stick around.
+			RequestReplan();
+		}
+	}
+
+	SpeculateTargetPaths();
+
+	// Far from the viewer the seeker is only ticked now and then and walks the skipped time along its path in one go.
+	// A world nobody is watching runs everything at full detail.
+	float viewerDistance = has_viewer ? glm::distance(viewer_position, finder->GetPosition()) : 0.0f;
+	simulation_lod->UpdateLevel(finder_lod_id, viewerDistance);
+	bool fullDetail = simulation_lod->GetLevel(finder_lod_id) == SimulationLod_Full;
+
+	float finderStep = 0.0f;
+	bool finderTicked = simulation_lod->Tick(finder_lod_id, fDelta, finderStep);
+	follower_steps.assign(path_follower->GetFollowerCount(), 0.0f);
+	follower_steps[finder_follower_id] = finderStep;
+	path_follower->Update(follower_steps);
+
+	if (fullDetail) {
+		SteerCrowd(fDelta);
 	}
+	else {
+		// Nobody can see it dodge from this far, so it just stands where its path says.
+		crowd->SetPreferredVelocity(finder_crowd_id, vector2());
+		if (path_follower->HasMoved(finder_follower_id)) {
+			vector3 pathPosition = path_follower->GetPosition(finder_follower_id);
+			crowd->SetPosition(finder_crowd_id, vector2(pathPosition.x, pathPosition.z));
+		}
+	}
+	crowd->Update(fDelta);
 
-	if (WeHavePaths()) {
+	bool crowdMoving = glm::length(crowd->GetVelocity(finder_crowd_id)) > 0.0f;
+	if (finderTicked && (path_follower->HasMoved(finder_follower_id) || crowdMoving)) {
 		MoveSeeker();
 	}
 
-	if (CheckCollisions()) {
+	if (simulation_lod->ShouldCollide(finder_lod_id) && CheckCollisions()) {
 		Collide(fDelta);
 	}
 }
 
 void Simplex::AStarSimulation::AddLinesToRenderList()
 {
-	for (uint i = 1; i < paths.size(); i++)
+	uint remainingCount = path_follower->GetRemainingCount(finder_follower_id);
+	for (uint i = 1; i < remainingCount; i++)
 	{
-		mesh_manager->AddLineToRenderList(IDENTITY_M4, paths[i], paths[i - 1], C_BLUE, C_BLUE);
+		vector3 from = path_follower->GetRemainingWaypoint(finder_follower_id, i - 1);
+		vector3 to = path_follower->GetRemainingWaypoint(finder_follower_id, i);
+		mesh_manager->AddLineToRenderList(IDENTITY_M4, to, from, C_BLUE, C_BLUE);
 	}
 }
 
@@ -84,110 +127,189 @@ void Simplex::AStarSimulation::AddObstacle()
 	}
 
 	Tile* tile = RandomFreeTile();
-	tile->EnableObstacle();
-	game_entity_manager->HideModelRender(tile->GetEntityId());
-	hidden_tile_list.push_back(tile);
+	if (!tile) return;
 
-	recalculate_a_star = true;
-	OverrideAStarTileCheck();
+	ApplyTileChanges(std::vector<Tile*>(1, tile), std::vector<Tile*>());
 }
 
 void Simplex::AStarSimulation::RemoveObstacle()
 {
-
-	int currentHidden = GetCurrentHidden();
-	if (currentHidden == 0) {
+	int randomIndex = hidden_tiles.Sample(world->GetRandomEngine());
+	if (randomIndex == -1) {
 		return;
 	}
 
-	int randomIndex = std::rand() % currentHidden;
+	ApplyTileChanges(std::vector<Tile*>(), std::vector<Tile*>(1, &tile_list[randomIndex]));
+}
 
-	Tile* tile = hidden_tile_list[randomIndex];
-	tile->RemoveObstacle();
-	game_entity_manager->ShowModelRender(tile->GetEntityId());
+// Where the world is being watched from, distant agents are simulated in less detail.
+void Simplex::AStarSimulation::SetViewerPosition(vector3 position)
+{
+	viewer_position = position;
+	has_viewer = true;
+}
 
-	hidden_tile_list.erase(hidden_tile_list.begin() + randomIndex);
+int Simplex::AStarSimulation::GetTotalObstacleCount() { return allowed_hidden_tiles; }
+int Simplex::AStarSimulation::GetCurrentHidden() { return hidden_tiles.GetSize();  }
+Simplex::SpeculativePlanner* Simplex::AStarSimulation::GetSpeculativePlanner() { return speculative_planner; }
+Simplex::NavigationMesh* Simplex::AStarSimulation::GetNavigationMesh() { return navigation_mesh; }
+Simplex::GridLineOfSight* Simplex::AStarSimulation::GetLineOfSight() { return line_of_sight; }
+Simplex::VoxelNavigation* Simplex::AStarSimulation::GetVoxelNavigation() { return voxel_navigation; }
+
+// Can the seeker see the target across the board without looking over a hole.
+bool Simplex::AStarSimulation::CanSeeTarget()
+{
+	vector3 from = finder->GetPosition();
+	vector3 to = target->GetPosition();
+	return line_of_sight->HasLineOfSight(vector2(from.x, from.z), vector2(to.x, to.z));
+}
 
-	recalculate_a_star = true;
-	OverrideAStarTileCheck();
+Simplex::EntityHandle Simplex::AStarSimulation::GetFinderHandle() { return finder_handle; }
+Simplex::EntityHandle Simplex::AStarSimulation::GetTargetHandle() { return target_handle; }
+
+Simplex::String Simplex::AStarSimulation::GetSeekerLodName()
+{
+	return simulation_lod->GetLevelName(simulation_lod->GetLevel(finder_lod_id));
 }
 
-int Simplex::AStarSimulation::GetTotalObstacleCount() { return allowed_hidden_tiles; }
-int Simplex::AStarSimulation::GetCurrentHidden() { return hidden_tile_list.size();  }
+// Cycle the seeker through the footprints the clearance map can answer for, one tile up to its cap.
+void Simplex::AStarSimulation::NextAgentSize()
+{
+	agent_size = agent_size % clearance_map->GetMaxClearance() + 1;
+	speculative_planner->DiscardPaths();
+	InvalidatePath();
+}
+
+int Simplex::AStarSimulation::GetAgentSize() { return agent_size; }
+
+void Simplex::AStarSimulation::NextPathfindingMode()
+{
+	pathfinding_mode = (pathfinding_mode + 1) % PathfindingMode_Count;
+	speculative_planner->DiscardPaths();
+	InvalidatePath();
+}
+
+Simplex::String Simplex::AStarSimulation::GetPathfindingModeName()
+{
+	if (pathfinding_mode == PathfindingMode_NavigationMesh) return "Navigation Mesh";
+	if (pathfinding_mode == PathfindingMode_AnyAngle) return "Any Angle";
+	if (pathfinding_mode == PathfindingMode_Voxels) return "Voxels";
+	return "Tiles";
+}
 # pragma endregion
 
 # pragma region A Star Init
-Simplex::AStarSimulation* Simplex::AStarSimulation::instance = nullptr;
-
-Simplex::AStarSimulation::AStarSimulation(int width, int height) { 
+Simplex::AStarSimulation::AStarSimulation(SimulationWorld* world, int width, int height) { 
 	Init(); 
+	this->world = world;
+	game_entity_manager = world->GetEntityManager();
 
 	map_width = width;
 	map_height = height;
 	map_area = width * height;
 	tile_list = new Tile[map_area];
+	free_tiles = TileIndexSet(map_area);
+	hidden_tiles = TileIndexSet(map_area);
+	replan_scheduler = new ReplanScheduler();
+	speculative_planner = new SpeculativePlanner();
+	navigation_mesh = new NavigationMesh(width, height);
+	line_of_sight = new GridLineOfSight(width, height);
+	clearance_map = new ClearanceMap(width, height);
+	voxel_navigation = new VoxelNavigation();
+	path_follower = new PathFollower();
+	path_follower->SetLineOfSight(line_of_sight);
+	crowd = new CrowdSimulation();
+	simulation_lod = new SimulationLod();
 
 	allowed_hidden_tiles = (int)((width * height) * 0.25f);
+	BuildExplosionStencil(3);
 
-	std::srand(std::time(nullptr));
+	// Tile (x, z) covers [x, x + 1] by [z, z + 1] cells out from the origin, so finding a tile is just a divide.
+	grid_origin = vector3(0.0f, floor_level, 0.0f);
+	cell_size = 1.0f;
 
-	// Generate the map tiles.
-	for (int i = 0; i < width * height; i++)
-	{
-		float x = (float)((int)(i / width));
-		float z = i % height;
-		vector3 tilePosition = vector3(x, floor_level, z);
+	// Read every model we need at once on worker threads, the entities below only wait for the files they use.
+	game_entity_manager->PrefetchModels({ "Cube.obj", "Creeper.obj", "Steve.obj" });
 
-		String entityId = "Cube_" + std::to_string(i);
+	// Generate the map tiles. Every block goes in with one bulk add so a big board loads in linear time. The tiles are
+	// stored one column of map_height tiles per x, so tile (x, z) lives at z + x * map_height.
+	game_entity_manager->Reserve(game_entity_manager->GetEntityCount() + map_area + 2);
+	std::vector<String> tileIds;
+	std::vector<EntityHandle> tileHandles;
+	tileIds.reserve(map_area);
+	for (int i = 0; i < map_area; i++) tileIds.push_back("Cube_" + std::to_string(i));
+	game_entity_manager->AddEntities("Cube.obj", tileIds, tileHandles);
 
+	for (int i = 0; i < map_area; i++)
+	{
+		float x = (float)((int)(i / height));
+		float z = i % height;
+		vector3 tilePosition = grid_origin + vector3(x, 0.0f, z) * cell_size;
 
-		Tile tile(entityId, tilePosition, i);
+		Tile tile(tileHandles[i], tilePosition, i);
 		tile_list[i] = tile;
 
+		voxel_navigation->SetSolid((int)x, floor_level, (int)z, true);
 
-		CreateEntity("Cube.obj", entityId, tilePosition);
-		game_entity_manager->DisableRigidBody(entityId);
-
+		GameEntity* tileEntity = game_entity_manager->GetEntity(tileHandles[i]);
+		if (tileEntity) {
+			tileEntity->SetTransform(tilePosition);
+			tileEntity->DisableRigidBody();
+		}
+		free_tiles.Insert(i);
 	}
 
 	// Create the creeper which will act as the finder.
-	CreateEntity("Creeper.obj", "Creeper", RandomFreeTile()->GetPosition());
-	game_entity_manager->UsePhysics();
-	finder = game_entity_manager->GetEntity();
+	finder_handle = CreateEntity("Creeper.obj", "Creeper", RandomFreeTile()->GetPosition());
+	finder = game_entity_manager->GetEntity(finder_handle);
+	finder->UsePhysics();
 
 	// Create Steve which will act as the target
-	CreateEntity("Steve.obj", "Steve", RandomFreeTile()->GetPosition());
-	game_entity_manager->UsePhysics();
-	target = game_entity_manager->GetEntity();
-	
+	target_handle = CreateEntity("Steve.obj", "Steve", RandomFreeTile()->GetPosition());
+	target = game_entity_manager->GetEntity(target_handle);
+	target->UsePhysics();
+
+	// Plan the first path as soon as the simulation starts.
+	finder_schedule_id = replan_scheduler->AddAgent();
+	finder_follower_id = path_follower->AddFollower();
+	vector3 finderPosition = finder->GetPosition();
+	finder_crowd_id = crowd->AddAgent(vector2(finderPosition.x, finderPosition.z), 0.4f, 3.0f);
+	finder_lod_id = simulation_lod->AddAgent();
+	RequestReplan(true);
 }
 
 Simplex::AStarSimulation::AStarSimulation(AStarSimulation const& other) { }
 Simplex::AStarSimulation& Simplex::AStarSimulation::operator=(AStarSimulation const& other) { return *this; }
 Simplex::AStarSimulation::~AStarSimulation(void) { Destroy(); }
 
-void Simplex::AStarSimulation::CreateEntity(String fileName, String entityId, vector3 position)
+Simplex::EntityHandle Simplex::AStarSimulation::CreateEntity(String fileName, String entityId, vector3 position)
 {
-	// Refactor to custom block creation method.
-	game_entity_manager->AddEntity(fileName, entityId);
-
-	matrix4 m4Position = glm::translate(position);
-	game_entity_manager->SetModelMatrix(m4Position);
+	EntityHandle handle = game_entity_manager->AddEntity(fileName, entityId);
+	game_entity_manager->SetTransform(position, quaternion(), handle);
+	return handle;
 }
 
+// Pick a random active tile nobody is standing on. Returns null when there is no such tile left.
 Simplex::Tile* Simplex::AStarSimulation::RandomFreeTile()
 {
-	do {
-		int randomIndex = std::rand() % map_area;
+	// Take the tiles under the entities out of the draw for a moment so we never have to roll again.
+	Tile* standingTiles[2] = { nullptr, nullptr };
+	if (target) standingTiles[0] = GetClosestTile(target->GetPosition());
+	if (finder) standingTiles[1] = GetClosestTile(finder->GetPosition());
+
+	bool removed[2] = { false, false };
+	for (uint i = 0; i < 2; i++) {
+		if (standingTiles[i]) removed[i] = free_tiles.Remove(standingTiles[i]->GetIndex());
+	}
 
-		Tile* tile = &tile_list[randomIndex];
+	int randomIndex = free_tiles.Sample(world->GetRandomEngine());
 
-		// Need to check to see if the tile we just removed is beneath the enemies
-		if (tile->GetActive() && NoOneStandingOnTile(tile)) {
-			return tile;
-		}
+	for (uint i = 0; i < 2; i++) {
+		if (removed[i]) free_tiles.Insert(standingTiles[i]->GetIndex());
+	}
 
-	} while (true && hidden_tile_list.size() < map_area); // Keep going until we can't no more. Double check that we are not hidding more than we should!
+	if (randomIndex == -1) return nullptr;
+	return &tile_list[randomIndex];
 }
 
 bool Simplex::AStarSimulation::NoOneStandingOnTile(Tile* tile)
@@ -197,47 +319,119 @@ bool Simplex::AStarSimulation::NoOneStandingOnTile(Tile* tile)
 	return true;
 }
 
+// Grid coordinates of the tile under a world position. False when the position is off the board.
+bool Simplex::AStarSimulation::WorldToGrid(vector3 position, int& x, int& z)
+{
+	x = (int)glm::floor((position.x - grid_origin.x) / cell_size);
+	z = (int)glm::floor((position.z - grid_origin.z) / cell_size);
+	return x >= 0 && z >= 0 && x < map_width && z < map_height;
+}
+
 Simplex::Tile* Simplex::AStarSimulation::GetClosestTile(vector3 position)
 {
-	for (uint i = 0; i < map_area; i++) {
-		Tile* tile = &tile_list[i];
+	int x, z;
+	if (!WorldToGrid(position, x, z)) return nullptr;
+	return &tile_list[z + (x * map_height)];
+}
 
-		if (PointInsideTile(position, tile)) {
-			return tile;
+// Like GetClosestTile, but a position sitting on the edge of a hole counts as standing on the active tile across the
+// edge. Path corners can land exactly on a tile border and floor would otherwise drop them into the hole.
+Simplex::Tile* Simplex::AStarSimulation::GetStandingTile(vector3 position)
+{
+	Tile* tile = GetClosestTile(position);
+	if (tile == nullptr || tile->GetActive()) return tile;
+
+	float epsilon = 0.001f * cell_size;
+	for (int dx = -1; dx <= 1; dx++) {
+		for (int dz = -1; dz <= 1; dz++) {
+			Tile* neighbor = GetClosestTile(position + vector3(dx * epsilon, 0.0f, dz * epsilon));
+			if (neighbor != nullptr && neighbor->GetActive()) return neighbor;
 		}
 	}
+	return tile;
+}
 
-	return nullptr;
+// Look up the tiles under a whole list of positions at once.
+void Simplex::AStarSimulation::GetClosestTiles(std::vector<vector3> const& positions, std::vector<Tile*>& tiles)
+{
+	tiles.resize(positions.size());
+
+	float inverseCellSize = 1.0f / cell_size;
+	for (uint i = 0; i < positions.size(); i++) {
+		int x = (int)glm::floor((positions[i].x - grid_origin.x) * inverseCellSize);
+		int z = (int)glm::floor((positions[i].z - grid_origin.z) * inverseCellSize);
+		bool onBoard = x >= 0 && z >= 0 && x < map_width && z < map_height;
+		tiles[i] = onBoard ? &tile_list[z + (x * map_height)] : nullptr;
+	}
 }
 
-bool Simplex::AStarSimulation::PointInsideTile(vector3 position, Tile* tile)
+// Collect the active tiles in the ring of eight around a tile.
+void Simplex::AStarSimulation::GetActiveTilesAround(Tile* tile, std::vector<Tile*>& tiles)
 {
-	ObjectRigidBody* tileRigidBody = game_entity_manager->GetRigidBody(tile->GetEntityId());
+	int index = tile->GetIndex();
+	int x = (int)(index / map_height);
+	int z = index % map_height;
 
-	vector3 blockCenter = tileRigidBody->GetCenterGlobal();
-	vector3 halfWidth = tileRigidBody->GetHalfWidth();
+	for (int checkX = x - 1; checkX <= x + 1; checkX++) {
+		for (int checkZ = z - 1; checkZ <= z + 1; checkZ++) {
+			if (checkX < 0 || checkZ < 0 || checkX >= map_width || checkZ >= map_height) continue;
 
-	if (position.x <= blockCenter.x + halfWidth.x &&
-		position.x >= blockCenter.x - halfWidth.x &&
-		position.z <= blockCenter.z + halfWidth.z &&
-		position.z >= blockCenter.z - halfWidth.z)
-	{
-		return true;
+			Tile* neighbor = &tile_list[checkZ + (checkX * map_height)];
+			if (neighbor != tile && neighbor->GetActive()) tiles.push_back(neighbor);
+		}
 	}
+}
 
-	return false;
+// Collect the tiles the seeker can stand on with its footprint still covering the given tile. The footprint grows
+// towards +x and +z from the tile it stands on, so these are the tiles up to agent_size - 1 behind it.
+void Simplex::AStarSimulation::GetFittingTilesOver(Tile* tile, std::vector<Tile*>& tiles)
+{
+	int index = tile->GetIndex();
+	int x = (int)(index / map_height);
+	int z = index % map_height;
+
+	for (int checkX = x - agent_size + 1; checkX <= x; checkX++) {
+		for (int checkZ = z - agent_size + 1; checkZ <= z; checkZ++) {
+			if (checkX < 0 || checkZ < 0) continue;
+
+			Tile* standing = &tile_list[checkZ + (checkX * map_height)];
+			if (standing->GetActive() && clearance_map->CanFit(checkX, checkZ, agent_size)) tiles.push_back(standing);
+		}
+	}
+}
+
+bool Simplex::AStarSimulation::TileFitsSeeker(Tile* tile)
+{
+	int index = tile->GetIndex();
+	return clearance_map->CanFit(index / map_height, index % map_height, agent_size);
 }
+
+bool Simplex::AStarSimulation::PointInsideTile(vector3 position, Tile* tile) { return GetClosestTile(position) == tile; }
 # pragma endregion
 
 # pragma region A Star Validation
 void Simplex::AStarSimulation::CheckIfWeNeedAStarUpdate()
 {
 	vector3 targetPosition = target->GetPosition();
-	if (target_last_position.x != targetPosition.x ||
-		target_last_position.z != targetPosition.z) {
-		recalculate_a_star = true;
+	if (target_last_position.x == targetPosition.x &&
+		target_last_position.z == targetPosition.z) {
+		return;
+	}
+
+	// Moving around inside the same tile does not change the path.
+	target_last_position = targetPosition;
+	if (GetClosestTile(targetPosition) == target_last_tile) {
+		return;
 	}
-		
+
+	RequestReplan();
+}
+
+// Ask the scheduler for a search. The scheduler decides when we actually get to run it.
+void Simplex::AStarSimulation::RequestReplan(bool forced)
+{
+	float targetDistance = glm::distance(finder->GetPosition(), target->GetPosition());
+	replan_scheduler->RequestReplan(finder_schedule_id, targetDistance, forced);
 }
 
 bool Simplex::AStarSimulation::ValidateAStarInput(Tile* startTile, Tile* endTile)
@@ -260,9 +454,8 @@ bool Simplex::AStarSimulation::ValidateAStarInput(Tile* startTile, Tile* endTile
 	}
 
 
-	// Don't run A Star if both tiles are inactive. (This is for floating Steve.)
-	if (!endTile->GetActive() ||
-		!startTile->GetActive()) {
+	// Don't run A Star if the seeker is not on an active tile. Floating Steve is handled by searching for the edge.
+	if (!startTile->GetActive()) {
 		target_last_position = target->GetPosition();
 		return false;
 	}
@@ -275,23 +468,320 @@ void Simplex::AStarSimulation::OverrideAStarTileCheck()
 	target_last_position = vector3();
 	target_last_tile = nullptr;
 }
+
+// Hide and show a batch of tiles in one go. The renderer and everything we built from the board see the whole change
+// set at once, and the seeker replans at most once no matter how many tiles changed.
+void Simplex::AStarSimulation::ApplyTileChanges(std::vector<Tile*> const& hiddenTiles, std::vector<Tile*> const& shownTiles)
+{
+	if (hiddenTiles.empty() && shownTiles.empty()) return;
+
+	bool replan = false;
+	std::vector<NavigationMesh::TileChange> meshChanges;
+
+	for (uint i = 0; i < hiddenTiles.size(); i++) {
+		Tile* tile = hiddenTiles[i];
+		tile->EnableObstacle();
+		game_entity_manager->HideModelRender(tile->GetEntityHandle());
+		SetTileWalkable(tile->GetIndex(), false, meshChanges);
+
+		replan = replan || PathBlockedBy(tile);
+	}
+
+	for (uint i = 0; i < shownTiles.size(); i++) {
+		Tile* tile = shownTiles[i];
+		tile->RemoveObstacle();
+		game_entity_manager->ShowModelRender(tile->GetEntityHandle());
+		SetTileWalkable(tile->GetIndex(), true, meshChanges);
+
+		replan = replan || PathShortenedBy(tile);
+	}
+
+	// The mesh re-covers everything the change set touched in one go.
+	navigation_mesh->SetWalkable(meshChanges);
+
+	speculative_planner->DiscardPaths(); // Searched on the old board.
+	if (replan) InvalidatePath();
+}
+
+// Keep everything we built from the board in step with one tile. The navigation mesh change is only queued, the mesh
+// is rebuilt once for the whole change set.
+void Simplex::AStarSimulation::SetTileWalkable(int index, bool walkable, std::vector<NavigationMesh::TileChange>& meshChanges)
+{
+	int x = index / map_height;
+	int z = index % map_height;
+
+	if (walkable) {
+		hidden_tiles.Remove(index);
+		free_tiles.Insert(index);
+	} else {
+		free_tiles.Remove(index);
+		hidden_tiles.Insert(index);
+	}
+
+	NavigationMesh::TileChange meshChange;
+	meshChange.x = x;
+	meshChange.z = z;
+	meshChange.walkable = walkable;
+	meshChanges.push_back(meshChange);
+
+	line_of_sight->SetWalkable(x, z, walkable);
+	clearance_map->SetWalkable(x, z, walkable);
+	voxel_navigation->SetSolid(x, floor_level, z, walkable);
+}
+
+// Force A Star to run on the next update even if the target is still standing on the same tile.
+void Simplex::AStarSimulation::InvalidatePath()
+{
+	OverrideAStarTileCheck();
+	RequestReplan(true);
+}
+
+// A new obstacle only matters if the seeker still has to walk over it, or it leaves no room for the seeker's footprint.
+bool Simplex::AStarSimulation::PathBlockedBy(Tile* tile) { return TileOnRemainingPath(tile) || RemainingPathTooTight(); }
+
+// An opened tile only matters if a detour through it could beat the path we already have. The distance from the
+// start of the path to the tile and on to the end is a lower bound for any such detour.
+bool Simplex::AStarSimulation::PathShortenedBy(Tile* tile)
+{
+	// Without a path the target was unreachable. The opened tile might connect us again.
+	if (!WeHavePaths()) return true;
+
+	vector3 tilePosition = tile->GetPosition();
+	vector3 pathStart = path_follower->GetRemainingWaypoint(finder_follower_id, 0);
+	vector3 pathEnd = path_follower->GetRemainingWaypoint(finder_follower_id, path_follower->GetRemainingCount(finder_follower_id) - 1);
+	float lowerBound = PathDistance(pathStart, tilePosition) + PathDistance(tilePosition, pathEnd);
+
+	return lowerBound < RemainingPathLength();
+}
+
+bool Simplex::AStarSimulation::TileOnRemainingPath(Tile* tile)
+{
+	uint remainingCount = path_follower->GetRemainingCount(finder_follower_id);
+	for (uint i = 1; i < remainingCount; i++) {
+		vector3 from = path_follower->GetRemainingWaypoint(finder_follower_id, i - 1);
+		vector3 to = path_follower->GetRemainingWaypoint(finder_follower_id, i);
+		if (SegmentCrossesTile(from, to, tile)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// A seeker bigger than one tile also covers the tiles up to agent_size - 1 towards +x and +z of every tile it walks
+// over. A hole there leaves the path too tight even though the path line never crosses it.
+bool Simplex::AStarSimulation::RemainingPathTooTight()
+{
+	if (agent_size == 1 || !UsesClearance()) return false;
+
+	// The first waypoint is where the seeker is now. It may have been dropped somewhere tight and is walking out of it.
+	uint remainingCount = path_follower->GetRemainingCount(finder_follower_id);
+	for (uint i = 1; i < remainingCount; i++) {
+		int x, z;
+		if (!WorldToGrid(path_follower->GetRemainingWaypoint(finder_follower_id, i), x, z)) continue;
+		if (!clearance_map->CanFit(x, z, agent_size)) return true;
+	}
+
+	return false;
+}
+
+// Clip the path segment against the square of the tile. Segments that only run along the edge of the tile don't count.
+bool Simplex::AStarSimulation::SegmentCrossesTile(vector3 from, vector3 to, Tile* tile)
+{
+	vector3 tileCenter = tile->GetPosition();
+	float start[2] = { from.x, from.z };
+	float delta[2] = { to.x - from.x, to.z - from.z };
+	float low[2] = { tileCenter.x - 0.499f, tileCenter.z - 0.499f };
+	float high[2] = { tileCenter.x + 0.499f, tileCenter.z + 0.499f };
+
+	float enter = 0.0f;
+	float exit = 1.0f;
+	for (uint axis = 0; axis < 2; axis++) {
+		if (glm::abs(delta[axis]) < 0.0001f) {
+			if (start[axis] < low[axis] || start[axis] > high[axis]) return false;
+			continue;
+		}
+
+		float t0 = (low[axis] - start[axis]) / delta[axis];
+		float t1 = (high[axis] - start[axis]) / delta[axis];
+		if (t0 > t1) std::swap(t0, t1);
+
+		enter = glm::max(enter, t0);
+		exit = glm::min(exit, t1);
+		if (enter > exit) return false;
+	}
+
+	return true;
+}
+
+float Simplex::AStarSimulation::RemainingPathLength()
+{
+	float length = 0.0f;
+	uint remainingCount = path_follower->GetRemainingCount(finder_follower_id);
+	for (uint i = 1; i < remainingCount; i++) {
+		length += glm::distance(path_follower->GetRemainingWaypoint(finder_follower_id, i - 1),
+			path_follower->GetRemainingWaypoint(finder_follower_id, i));
+	}
+	return length;
+}
 # pragma endregion
 
 # pragma region A Star Algorithm
 void Simplex::AStarSimulation::CalculateAStarBetweenTiles(Tile* startTile, Tile* endTile)
 {
+	if (!endTile->GetActive()) {
+		// The target is floating over a hole. Head for whichever tile around it is the closest walk away.
+		std::vector<Tile*> goalTiles;
+		GetActiveTilesAround(endTile, goalTiles);
+		if (UsesClearance()) {
+			// A big seeker can only stop where it fits, so stand wherever its footprint covers one of those tiles.
+			std::vector<Tile*> edgeTiles;
+			edgeTiles.swap(goalTiles);
+			for (uint i = 0; i < edgeTiles.size(); i++) GetFittingTilesOver(edgeTiles[i], goalTiles);
+		}
+		SearchNearestPath(startTile, goalTiles, paths);
+	} else if (UsesClearance() && !TileFitsSeeker(endTile)) {
+		// The seeker is too big to stand on the target's tile, say against the +x or +z edge. Stand on whichever tile
+		// puts its footprint over the target instead.
+		std::vector<Tile*> goalTiles;
+		GetFittingTilesOver(endTile, goalTiles);
+		SearchNearestPath(startTile, goalTiles, paths);
+	} else if (!speculative_planner->TakePath(endTile->GetIndex(), startTile->GetPosition(), paths)) {
+		// Skip the search if the target went where we guessed it would.
+		SearchPath(startTile, endTile, paths);
+	}
+
+	path_follower->SetPath(finder_follower_id, paths);
+
+	// The target is on a new tile so the rest of the guesses are useless.
+	speculative_planner->DiscardPaths();
+
+	target_last_tile = endTile;
+}
+
+// Only the tile searches keep the seeker's footprint out of tight spots.
+bool Simplex::AStarSimulation::UsesClearance()
+{
+	return pathfinding_mode == PathfindingMode_Tiles || pathfinding_mode == PathfindingMode_AnyAngle;
+}
+
+// Run A Star and write the path into the given list. The list is left empty if the end tile can't be reached.
+bool Simplex::AStarSimulation::SearchPath(Tile* startTile, Tile* endTile, std::vector<vector3>& path)
+{
+	if (pathfinding_mode == PathfindingMode_NavigationMesh) {
+		vector3 startPosition = startTile->GetPosition();
+		startPosition.y = -floor_level;
+		return navigation_mesh->FindPath(startPosition, endTile->GetPosition(), path);
+	}
+
+	if (pathfinding_mode == PathfindingMode_Voxels) {
+		// Search from the voxel of air sitting on each tile, then lift the waypoints up to where entities stand.
+		vector3 startPosition = startTile->GetPosition();
+		vector3 endPosition = endTile->GetPosition();
+		startPosition.y = floor_level + 1;
+		endPosition.y = floor_level + 1;
+
+		if (!voxel_navigation->FindPath(startPosition, endPosition, path)) return false;
+
+		float standingOffset = -floor_level - (floor_level + 1);
+		for (uint i = 0; i < path.size(); i++) {
+			path[i].y += standingOffset;
+		}
+		return true;
+	}
+
 	AStarSetup(startTile, endTile);
+	path.clear();
 
 	// If the A Star was succesful then get the path from the tiles
-	if (AStarAlgo(startTile, endTile, 0)) {
-		GetPathFromTiles(startTile, endTile);
+	if (!AStarAlgo(startTile, endTile, 0)) {
+		return false;
 	}
 
-	target_last_tile = endTile;
+	GetPathFromTiles(startTile, endTile, path);
+	// Line of sight only looks at the tiles under the line, so it can't vouch for anything wider than one tile.
+	if (pathfinding_mode == PathfindingMode_AnyAngle && agent_size == 1) SmoothPath(path);
+	return true;
+}
+
+// Run one search that ends at whichever goal tile is nearest and return its index, or -1 if none can be reached.
+// The tile search seeds every goal and runs backwards to the start tile, so the heuristic only aims at one tile and
+// the parents already point from the start towards the goal.
+int Simplex::AStarSimulation::SearchNearestPath(Tile* startTile, std::vector<Tile*> const& goalTiles, std::vector<vector3>& path)
+{
+	path.clear();
+
+	// The other modes search their own graphs, which take every goal at once as well.
+	if (pathfinding_mode == PathfindingMode_NavigationMesh) {
+		vector3 startPosition = startTile->GetPosition();
+		startPosition.y = -floor_level;
+
+		std::vector<vector3> goals;
+		for (uint i = 0; i < goalTiles.size(); i++) goals.push_back(goalTiles[i]->GetPosition());
+		return navigation_mesh->FindNearestPath(startPosition, goals, path);
+	}
+
+	if (pathfinding_mode == PathfindingMode_Voxels) {
+		vector3 startPosition = startTile->GetPosition();
+		startPosition.y = floor_level + 1;
+
+		std::vector<vector3> goals;
+		for (uint i = 0; i < goalTiles.size(); i++) {
+			goals.push_back(goalTiles[i]->GetPosition());
+			goals.back().y = floor_level + 1;
+		}
+
+		int goal = voxel_navigation->FindNearestPath(startPosition, goals, path);
+
+		float standingOffset = -floor_level - (floor_level + 1);
+		for (uint i = 0; i < path.size(); i++) {
+			path[i].y += standingOffset;
+		}
+		return goal;
+	}
+
+	AStarSetup(goalTiles, startTile);
+	if (open_tile_list.size() == 0) return -1;
+
+	int lowestIndex = 0;
+	for (int i = 0; i < open_tile_list.size(); i++)
+	{
+		if (open_tile_list[i]->GetF() < open_tile_list[lowestIndex]->GetF())
+			lowestIndex = i;
+	}
+
+	if (!AStarAlgo(open_tile_list[lowestIndex], startTile, lowestIndex)) {
+		return -1;
+	}
+
+	// Follow the parents forward until we reach the goal that seeded this branch.
+	Tile* currentTile = startTile;
+	while (true) {
+		vector3 position = currentTile->GetPosition();
+		position.y = -floor_level;
+
+		path.push_back(position);
+
+		if (currentTile->GetParent() == currentTile) break;
+		currentTile = currentTile->GetParent();
+	}
+
+	if (pathfinding_mode == PathfindingMode_AnyAngle && agent_size == 1) SmoothPath(path);
+
+	for (uint i = 0; i < goalTiles.size(); i++) {
+		if (goalTiles[i] == currentTile) return i;
+	}
+	return -1;
 }
 
 // Setup the A Star Algo. Reset from last run, then calculate heuristic value.
 void Simplex::AStarSimulation::AStarSetup(Tile* startTile, Tile* endTile)
+{
+	AStarSetup(std::vector<Tile*>(1, startTile), endTile);
+}
+
+// Same setup but every one of the start tiles is seeded into the open list.
+void Simplex::AStarSimulation::AStarSetup(std::vector<Tile*> const& startTiles, Tile* endTile)
 {
 	// Reset all cells, and then get the heuristic value for active cells.
 	for (uint i = 0; i < map_area; i++) {
@@ -303,7 +793,7 @@ void Simplex::AStarSimulation::AStarSetup(Tile* startTile, Tile* endTile)
 		float bigAppleDistance = map_area;
 
 		if (tile->GetActive()) {
-			bigAppleDistance = glm::abs(endTilePosition.x - tilePosition.x) + glm::abs(endTilePosition.z - tilePosition.z);
+			bigAppleDistance = ManhattanDistance(tilePosition, endTilePosition);
 		}
 
 		tile->SetH(bigAppleDistance);
@@ -313,17 +803,21 @@ void Simplex::AStarSimulation::AStarSetup(Tile* startTile, Tile* endTile)
 	// Reset the tiles.
 	open_tile_list.clear();
 	closed_tile_list.clear();
-	paths.clear();
 
 
-	// Prep the first tile.
-	startTile->SetParent(startTile);
-	startTile->SetG(0);
-	open_tile_list.push_back(startTile);
+	// Prep the first tiles.
+	for (uint i = 0; i < startTiles.size(); i++) {
+		Tile* startTile = startTiles[i];
+		if (startTile->GetParent()) continue;
+
+		startTile->SetParent(startTile);
+		startTile->SetG(0);
+		open_tile_list.push_back(startTile);
+	}
 }
 
 // Get the backwards path from the end tile then reverse the path.
-void Simplex::AStarSimulation::GetPathFromTiles(Tile* startTile, Tile* endTile)
+void Simplex::AStarSimulation::GetPathFromTiles(Tile* startTile, Tile* endTile, std::vector<vector3>& path)
 {
 	// Get the reverse path from the end tile. That is the path.
 	Tile* currentTile = endTile;
@@ -332,13 +826,63 @@ void Simplex::AStarSimulation::GetPathFromTiles(Tile* startTile, Tile* endTile)
 		vector3 position = currentTile->GetPosition();
 		position.y = -floor_level;
 
-		paths.push_back(position);
+		path.push_back(position);
 
 		if (currentTile == startTile) break;
 		currentTile = currentTile->GetParent();
 	}
 
-	std::reverse(paths.begin(), paths.end());
+	std::reverse(path.begin(), path.end());
+}
+
+// Cut the staircase out of a tile path. From each kept waypoint test every later waypoint in one batch and jump to
+// the furthest one in plain sight, the neighbouring waypoint is always visible so we keep moving forward.
+void Simplex::AStarSimulation::SmoothPath(std::vector<vector3>& path)
+{
+	if (path.size() < 3) return;
+
+	std::vector<vector3> smoothPath;
+	std::vector<vector2> from;
+	std::vector<vector2> to;
+	std::vector<char> visible;
+	uint anchor = 0;
+
+	smoothPath.push_back(path[anchor]);
+	while (anchor < path.size() - 1) {
+		from.assign(path.size() - anchor - 1, vector2(path[anchor].x, path[anchor].z));
+		to.clear();
+		for (uint i = anchor + 1; i < path.size(); i++) {
+			to.push_back(vector2(path[i].x, path[i].z));
+		}
+
+		line_of_sight->HasLineOfSight(from, to, visible);
+
+		uint next = anchor + 1;
+		for (uint i = visible.size(); i > 1; i--) {
+			if (visible[i - 1]) {
+				next = anchor + i;
+				break;
+			}
+		}
+
+		anchor = next;
+		smoothPath.push_back(path[anchor]);
+	}
+
+	path.swap(smoothPath);
+}
+
+// Distance between two positions on the board when we can only move along the x and z axis.
+float Simplex::AStarSimulation::ManhattanDistance(vector3 from, vector3 to)
+{
+	return glm::abs(to.x - from.x) + glm::abs(to.z - from.z);
+}
+
+// Shortest distance the current pathfinding mode could possibly travel between two positions.
+float Simplex::AStarSimulation::PathDistance(vector3 from, vector3 to)
+{
+	if (pathfinding_mode == PathfindingMode_Tiles || pathfinding_mode == PathfindingMode_Voxels) return ManhattanDistance(from, to);
+	return glm::distance(vector2(from.x, from.z), vector2(to.x, to.z));
 }
 
 /// Run the recursive A Star algorithm to find the best path possible.
@@ -355,7 +899,7 @@ bool Simplex::AStarSimulation::AStarAlgo(Tile* currentTile, Tile* endTile, int o
 	// Get the x, and z vars from the index.
 	int index = currentTile->GetIndex();
 
-	int x = (int)(index / map_width);
+	int x = (int)(index / map_height);
 	int z = index % map_height;
 
 
@@ -373,10 +917,13 @@ bool Simplex::AStarSimulation::AStarAlgo(Tile* currentTile, Tile* endTile, int o
 		// We found a valid cell in the map
 		if (checkX >= 0 && checkZ >= 0 && checkZ < map_height && checkX < map_width)
 		{
-			Tile* tile = &tile_list[checkZ + (checkX * map_width)];
+			Tile* tile = &tile_list[checkZ + (checkX * map_height)];
 
-			// Skip the inactive tiles. And the tiles which already have a parent
+			// Skip the inactive tiles, the tiles too tight for the seeker. And the tiles which already have a parent
+			// The tile we are searching for always counts. Searching backwards that is the seeker's own tile, and it may
+			// have been dropped somewhere it does not fit.
 			if (!tile->GetActive()) continue;
+			if (tile != endTile && !clearance_map->CanFit(checkX, checkZ, agent_size)) continue;
 			if (tile->GetParent()) continue;
 
 			// Set the parent of the neighbhor tiles to the current cell.
@@ -405,81 +952,65 @@ bool Simplex::AStarSimulation::AStarAlgo(Tile* currentTile, Tile* endTile, int o
 }
 #pragma endregion
 
-# pragma region Entity Movement
-// Move the seeker on the path created from the a star algorithm
-void Simplex::AStarSimulation::MoveSeeker()
+# pragma region Speculative Planning
+// Use the searches left over this frame to plan toward the tiles the target is heading for.
+void Simplex::AStarSimulation::SpeculateTargetPaths()
 {
-	// Path Finding Behavior for the Creeper
-	static float fTimer = 0;
-	static uint uClock = system->GenClock();
-	fTimer += system->GetDeltaTime(uClock);
+	Tile* startTile = this->GetStandingTile(finder->GetPosition());
+	Tile* targetTile = this->GetClosestTile(target->GetPosition());
+	if (!startTile || !targetTile || !startTile->GetActive()) return;
 
-	StartPathFindingIfNotMoving();
+	std::vector<vector3> predictions;
+	speculative_planner->PredictNextTiles(targetTile->GetPosition(), target->GetVelocity(), predictions);
 
-	//Lerp and store results in v3CurrentPos.
-	vector3 v3CurrentPos;
-	float fPercentage = static_cast<float>(MapValue(fTimer, 0.0f, 0.6f, 0.0f, 1.0f));
-	v3CurrentPos = glm::lerp(traveling_from, traveling_to, fPercentage);
+	std::vector<Tile*> goalTiles;
+	GetClosestTiles(predictions, goalTiles);
 
-	// Made it to the next node. Lets remove the path.
-	if (fPercentage >= 1.0)
-	{
-		GetNextPath();
-		fTimer = system->GetDeltaTime(uClock);
-	}
+	for (uint i = 0; i < goalTiles.size(); i++) {
+		Tile* goalTile = goalTiles[i];
+		if (!goalTile || !goalTile->GetActive()) continue;
+		if (UsesClearance() && !TileFitsSeeker(goalTile)) continue;
+		if (speculative_planner->HasPath(goalTile->GetIndex())) continue;
 
+		if (!replan_scheduler->UseSpareSearch()) return;
 
-	// Move the finder!
-	v3CurrentPos.y = 0.0; // This is important since we are a Creeper. Ideally we abstract this out a litle.
-	matrix4 m4Finder = glm::translate(v3CurrentPos);
-	m4Finder = glm::rotate(m4Finder, GetMovingDirctionRotation(), AXIS_Y);
-	finder->SetModelMatrix(m4Finder);
-
+		std::vector<vector3> path;
+		SearchPath(startTile, goalTile, path);
+		speculative_planner->StorePath(goalTile->GetIndex(), path);
+	}
 }
+#pragma endregion
 
-// Get the moving direction rotation. Returns the angle in degrees for which way for the creeper to face.
-float Simplex::AStarSimulation::GetMovingDirctionRotation()
+# pragma region Entity Movement
+// Every walker wants to be wherever its path follower got to this frame. The crowd then bends that into a velocity that
+// keeps clear of the other walkers.
+void Simplex::AStarSimulation::SteerCrowd(float fDelta)
 {
-	float rotationAngle = 0.0f;
-	if (traveling_to.x > traveling_from.x) rotationAngle = 90.0f;
-	if (traveling_to.z < traveling_from.z) rotationAngle = 180.0f;
-	if (traveling_to.x < traveling_from.x) rotationAngle = 270.0f;
-	return glm::radians(rotationAngle);
+	vector2 preferredVelocity;
+	if (path_follower->HasMoved(finder_follower_id) && fDelta > 0.0f) {
+		vector3 pathPosition = path_follower->GetPosition(finder_follower_id);
+		preferredVelocity = (vector2(pathPosition.x, pathPosition.z) - crowd->GetPosition(finder_crowd_id)) / fDelta;
+	}
+
+	crowd->SetPreferredVelocity(finder_crowd_id, preferredVelocity);
 }
 
-// Get the next path in the sequence of paths.
-void Simplex::AStarSimulation::GetNextPath()
+// Place the seeker wherever the crowd has walked it to.
+void Simplex::AStarSimulation::MoveSeeker()
 {
-	paths.erase(paths.begin());
-	traveling_from = traveling_to;
+	vector2 crowdPosition = crowd->GetPosition(finder_crowd_id);
+	vector3 v3CurrentPos = vector3(crowdPosition.x, 0.0f, crowdPosition.y);
 
-	// Bail out if we just removed the last path
-	if (!WeHavePaths())
-		return;
-
-	if (traveling_to == paths[0] && paths.size() > 1) {
-		traveling_to = paths[1];
-	} else {
-		traveling_to = paths[0];
-	}
-}
+	// Move the finder!
+	v3CurrentPos.y = 0.0; // This is important since we are a Creeper. Ideally we abstract this out a litle.
+	finder->SetTransform(v3CurrentPos, glm::angleAxis(path_follower->GetHeading(finder_follower_id), AXIS_Y));
 
-// Start up the pathfinding if we are not moving at the moment
-void Simplex::AStarSimulation::StartPathFindingIfNotMoving()
-{
-	if (traveling_from == vector3() &&
-		traveling_to == vector3() &&
-		paths.size() > 1)
-	{
-		traveling_from = paths[0];
-		traveling_to = paths[1];
-	}
 }
 
 // Check to see if we want to move the seeker. Only move the seeker when we are actually following a path.
 bool Simplex::AStarSimulation::WeHavePaths()
 {
-	return paths.size() != 0;
+	return path_follower->GetRemainingCount(finder_follower_id) != 0;
 }
 
 # pragma endregion
@@ -494,24 +1025,36 @@ bool Simplex::AStarSimulation::CheckCollisions()
 // Cause a collision between the two entities.
 void Simplex::AStarSimulation::Collide(float fDelta)
 {
-	// Collide with Steve
-	vector3 collisionVector = (traveling_to - traveling_from) * (fDelta * 20.0f);
-	game_entity_manager->ApplyForce(collisionVector, "Steve");
+	// Collide with Steve. Path segments can span several tiles so only the direction counts.
+	vector3 travelDirection = path_follower->GetDirection(finder_follower_id);
+	vector3 collisionVector = travelDirection * (fDelta * 20.0f);
+	game_entity_manager->ApplyForce(collisionVector, target_handle);
 
 	// Break Blocks
 	ExploadGround();
 	MoveCreeper();
 
-	// Restart the A Star algorithm
-	recalculate_a_star = true;
+	// Restart the A Star algorithm. The creeper was moved so the old path does not start where we are anymore.
 	RestartPathFinding();
-	OverrideAStarTileCheck();
+	InvalidatePath();
 }
 
 void Simplex::AStarSimulation::RestartPathFinding()
 {
-	traveling_from = vector3();
-	traveling_to = vector3();
+	path_follower->Stop(finder_follower_id);
+}
+
+// Offsets of every tile inside the blast radius, worked out once instead of on every explosion.
+void Simplex::AStarSimulation::BuildExplosionStencil(int radius)
+{
+	explosion_stencil.clear();
+
+	for (int offsetX = -radius; offsetX <= radius; offsetX++) {
+		for (int offsetZ = -radius; offsetZ <= radius; offsetZ++) {
+			if (offsetX * offsetX + offsetZ * offsetZ > radius * radius) continue;
+			explosion_stencil.push_back(std::make_pair(offsetX, offsetZ));
+		}
+	}
 }
 
 // Remove some tiles from the ground. Cause a EXPLOSION!!!!
@@ -521,66 +1064,65 @@ void Simplex::AStarSimulation::ExploadGround()
 	if (!exploadTile) return; // Bail out if we are floating
 
 	int exploadAmount = 6;
-	int exploadRadius = 3;
-	int bailOutAmount = 20;
-
 
-	// Remove all the exploaded blocks
-	for (int i = 0; i < exploadAmount; i++)
-	{
-		// Get the x, and z vars from the index.
-		int index = exploadTile->GetIndex();
-
-		int x = (int)(index / map_width);
-		int z = index % map_height;
-
-
-		// Keep track of if we found a block, and if we have not bailed out yet.
-		bool foundActiveBlock = false;
-		int bailOutTracker = 0;
-
-		do
-		{
-			int checkX = x + (-exploadRadius + (std::rand() % (exploadRadius * 2)));
-			int checkZ = z + (-exploadRadius + (std::rand() % (exploadRadius * 2)));
-
-			// Check the new block within radius
-			if (checkX >= 0 && checkZ >= 0 && checkZ < map_height && checkX < map_width)
-			{
+	// Get the x, and z vars from the index.
+	int index = exploadTile->GetIndex();
 
-				Tile* tile = &tile_list[checkZ + (checkX * map_width)];
+	int x = (int)(index / map_height);
+	int z = index % map_height;
 
-				// If we are active hide the block
-				if (tile->GetActive() && NoOneStandingOnTile(tile))
-				{
-					// Sacrifice another hole for this one.
-					if (GetCurrentHidden() >= allowed_hidden_tiles) RemoveObstacle();
 
-					tile->EnableObstacle();
-					game_entity_manager->HideModelRender(tile->GetEntityId());
+	// Every tile the blast can reach comes straight out of the stencil, no guessing offsets.
+	std::vector<Tile*> candidateTiles;
+	for (uint i = 0; i < explosion_stencil.size(); i++) {
+		int checkX = x + explosion_stencil[i].first;
+		int checkZ = z + explosion_stencil[i].second;
+		if (checkX < 0 || checkZ < 0 || checkZ >= map_height || checkX >= map_width) continue;
 
-					hidden_tile_list.push_back(tile);
-					foundActiveBlock = true;
-				}
+		Tile* tile = &tile_list[checkZ + (checkX * map_height)];
+		if (tile->GetActive() && NoOneStandingOnTile(tile)) candidateTiles.push_back(tile);
+	}
 
-			}
 
-			bailOutTracker++;
+	// Pick the blocks to blow up by shuffling the front of the candidate list.
+	std::vector<Tile*> hiddenTiles;
+	for (uint i = 0; i < exploadAmount && i < candidateTiles.size(); i++) {
+		uint pick = i + world->Random(candidateTiles.size() - i);
+		std::swap(candidateTiles[i], candidateTiles[pick]);
+		hiddenTiles.push_back(candidateTiles[i]);
+	}
 
-		} while (!foundActiveBlock && bailOutTracker <= bailOutAmount);
 
+	// Sacrifice old holes for the new ones so we stay under the limit.
+	std::vector<Tile*> shownTiles;
+	int currentHidden = GetCurrentHidden();
+	int sacrificeAmount = glm::min(currentHidden + (int)hiddenTiles.size() - allowed_hidden_tiles, currentHidden);
+	if (sacrificeAmount > 0) {
+		// Shuffle the front of the hidden set the same way, so every old hole is as likely to go as any other.
+		std::vector<int> holes;
+		for (int i = 0; i < currentHidden; i++) holes.push_back(hidden_tiles.GetMember(i));
+
+		for (int i = 0; i < sacrificeAmount; i++) {
+			uint pick = i + world->Random(holes.size() - i);
+			std::swap(holes[i], holes[pick]);
+			shownTiles.push_back(&tile_list[holes[i]]);
+		}
 	}
+
+	ApplyTileChanges(hiddenTiles, shownTiles);
 }
 
 // Move creeper to a random location.
 void Simplex::AStarSimulation::MoveCreeper()
 {	
 	Tile* tile = RandomFreeTile();
+	if (!tile) return;
+
 	vector3 tilePosition = tile->GetPosition();
 	tilePosition.y = 0.0;
 
-	matrix4 m4Creeper = glm::translate(tilePosition);
-	game_entity_manager->SetModelMatrix(m4Creeper, "Creeper");
+	game_entity_manager->SetTransform(tilePosition, quaternion(), finder_handle);
+	crowd->SetPosition(finder_crowd_id, vector2(tilePosition.x, tilePosition.z));
 
 }
 #pragma endregion
@@ -82,7 +82,7 @@ void Application::ProcessKeyPressed(sf::Event sfml_event)
 	{
 		case sf::Keyboard::Space:
 			sound_effect.play();
-			entity_manager->ApplyForce(vector3(0.0f, 1.0f, 0.0f), "Steve");
+			entity_manager->ApplyForce(vector3(0.0f, 1.0f, 0.0f), a_star_simulation->GetTargetHandle());
 			break;
 		case sf::Keyboard::LShift:
 		case sf::Keyboard::RShift:
@@ -131,6 +131,12 @@ void Application::ProcessKeyReleased(sf::Event sfml_event)
 		case sf::Keyboard::Subtract:
 			a_star_simulation->RemoveObstacle();
 			break;
+		case sf::Keyboard::N:
+			a_star_simulation->NextPathfindingMode();
+			break;
+		case sf::Keyboard::C:
+			a_star_simulation->NextAgentSize();
+			break;
 		case sf::Keyboard::LShift:
 		case sf::Keyboard::RShift:
 			shift_modifier_key_pressed = false;
@@ -305,20 +311,21 @@ void Application::ProcessKeyboard(void)
 
 #pragma region Character Position
 	float fDelta = system->GetDeltaTime(0);
+	EntityHandle steve = a_star_simulation->GetTargetHandle();
 	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) {
-		entity_manager->ApplyForce(vector3(-2.0f * fDelta, 0.0f, 0.0f), "Steve");
+		entity_manager->ApplyForce(vector3(-2.0f * fDelta, 0.0f, 0.0f), steve);
 	}
 
 	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) {
-		entity_manager->ApplyForce(vector3(2.0f * fDelta, 0.0f, 0.0f), "Steve");
+		entity_manager->ApplyForce(vector3(2.0f * fDelta, 0.0f, 0.0f), steve);
 	}
 
 	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) {
-		entity_manager->ApplyForce(vector3(0.0f, 0.0f, -2.0f * fDelta), "Steve");
+		entity_manager->ApplyForce(vector3(0.0f, 0.0f, -2.0f * fDelta), steve);
 	}
 
 	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) {
-		entity_manager->ApplyForce(vector3(0.0f, 0.0f, 2.0f * fDelta), "Steve");
+		entity_manager->ApplyForce(vector3(0.0f, 0.0f, 2.0f * fDelta), steve);
 	}
 
 #pragma endregion
@@ -87,7 +87,22 @@ void Application::DrawGUI(void)
 			ImGui::Separator();
 			ImGui::Text("Arrows: Apply force to Steve\n");
 			ImGui::Text("+/-: Add / remove holes\n");
+			ImGui::Text("N: Switch path mode\n");
+			ImGui::Text("C: Change creeper size (tile modes)\n");
 			ImGui::Text("Hole Counter: %i/%i\n", a_star_simulation->GetCurrentHidden(), a_star_simulation->GetTotalObstacleCount());
+			ImGui::Text("Path Mode: %s (%i rectangles)\n", a_star_simulation->GetPathfindingModeName().c_str(),
+				a_star_simulation->GetNavigationMesh()->GetRectangleCount());
+			ImGui::Text("Voxels: %i solid in %i chunks\n", a_star_simulation->GetVoxelNavigation()->GetSolidCount(),
+				a_star_simulation->GetVoxelNavigation()->GetChunkCount());
+			ImGui::Text("Creeper Size: %ix%i tiles%s\n", a_star_simulation->GetAgentSize(), a_star_simulation->GetAgentSize(),
+				a_star_simulation->UsesClearance() ? "" : " (not used in this mode)");
+			ImGui::Text("Creeper Sees Steve: %s\n", a_star_simulation->CanSeeTarget() ? "Yes" : "No");
+			ImGui::Text("Creeper Detail: %s\n", a_star_simulation->GetSeekerLodName().c_str());
+			ImGui::Separator();
+			SpeculativePlanner* speculativePlanner = a_star_simulation->GetSpeculativePlanner();
+			ImGui::Text("Speculative Hit Rate: %.0f%% (%i/%i)\n", speculativePlanner->GetHitRate() * 100.0f,
+				speculativePlanner->GetHitCount(), speculativePlanner->GetLookupCount());
+			ImGui::Text("Speculative Wasted: %i/%i searches\n", speculativePlanner->GetWastedCount(), speculativePlanner->GetSearchCount());
 		}
 		ImGui::End();
 	}
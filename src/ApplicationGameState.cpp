@@ -13,7 +13,9 @@ void Application::InitGameState(void)
 		AXIS_Y);					//Up
 
 	light_manager->SetPosition(vector3(0.0f, 3.0f, 13.0f), 1);
-	a_star_simulation = AStarSimulation::GetInstance();
+	world = new SimulationWorld((uint)std::time(nullptr));
+	a_star_simulation = world->GetSimulation();
+	entity_manager = world->GetEntityManager();
 }
 
 void Application::Run(void)
@@ -112,8 +114,12 @@ void Application::Update(void)
 	CameraRotation();
 
 	// Update entities in the scene and our simulation.
-	entity_manager->Update();
-	a_star_simulation->Update();
+	static uint sClock = system->GenClock();
+	world->SetViewerPosition(camera_manager->GetPosition());
+	world->Update(system->GetDeltaTime(sClock));
+
+	// Models finish loading here since this thread owns the GL context, one per frame so the window keeps drawing.
+	entity_manager->UploadModels();
 
 	// Add entities for next render.
 	entity_manager->AddEntityToRenderList(-1, true);
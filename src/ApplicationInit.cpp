@@ -21,8 +21,9 @@ Application::~Application(void)
 
 void Application::Release(void)
 {
-	GameEntityManager::ReleaseInstance();
-	AStarSimulation::ReleaseInstance();
+	SafeDelete(world);
+	a_star_simulation = nullptr;
+	entity_manager = nullptr;
 	ShutdownGUI();
 }
 
@@ -91,8 +92,6 @@ void Application::Init(String application_name, uint window_with, uint window_he
 
 	InitControllers();
 
-	entity_manager = GameEntityManager::GetInstance();
-
 	InitGameState();
 
 	application_initialized = true;
@@ -0,0 +1,122 @@
+/*
+* Implementation of the clearance map. A tile's clearance only depends on the tiles to its +x and +z, so sweeping
+* backwards from the far corner fills the whole map in one pass.
+*/
+#include "headers/ClearanceMap.h"
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void ClearanceMap::Release(void)
+{
+	walkable.clear();
+	clearance.clear();
+}
+
+void ClearanceMap::Init(void)
+{
+	grid_width = 0;
+	grid_height = 0;
+	max_clearance = 4;
+}
+
+ClearanceMap::ClearanceMap(int width, int height, int max_clearance)
+{
+	Init();
+	grid_width = width;
+	grid_height = height;
+	this->max_clearance = glm::max(max_clearance, 1);
+	walkable.assign(width * height, true);
+	clearance.assign(width * height, 0);
+	Build();
+}
+
+ClearanceMap::ClearanceMap(ClearanceMap const& other)
+{
+	grid_width = other.grid_width;
+	grid_height = other.grid_height;
+	max_clearance = other.max_clearance;
+	walkable = other.walkable;
+	clearance = other.clearance;
+}
+
+ClearanceMap& ClearanceMap::operator=(ClearanceMap const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		ClearanceMap temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+ClearanceMap::~ClearanceMap() { Release(); }
+
+void ClearanceMap::Swap(ClearanceMap& other)
+{
+	std::swap(grid_width, other.grid_width);
+	std::swap(grid_height, other.grid_height);
+	std::swap(max_clearance, other.max_clearance);
+	std::swap(walkable, other.walkable);
+	std::swap(clearance, other.clearance);
+}
+#pragma endregion
+
+#pragma region Clearance
+void ClearanceMap::Build(void)
+{
+	for (int z = grid_height - 1; z >= 0; z--) {
+		for (int x = grid_width - 1; x >= 0; x--) {
+			UpdateTile(x, z);
+		}
+	}
+}
+
+// A tile changing can only shrink or grow the squares that contain it. With the values capped those all start
+// within max_clearance - 1 tiles behind it, so only that corner of the map is swept again.
+void ClearanceMap::SetWalkable(int x, int z, bool is_walkable)
+{
+	if (x < 0 || z < 0 || x >= grid_width || z >= grid_height) {
+		return;
+	}
+
+	int index = z * grid_width + x;
+	if (walkable[index] == is_walkable) return;
+	walkable[index] = is_walkable;
+
+	int minX = glm::max(x - max_clearance + 1, 0);
+	int minZ = glm::max(z - max_clearance + 1, 0);
+	for (int updateZ = z; updateZ >= minZ; updateZ--) {
+		for (int updateX = x; updateX >= minX; updateX--) {
+			UpdateTile(updateX, updateZ);
+		}
+	}
+}
+
+int ClearanceMap::GetClearance(int x, int z)
+{
+	if (x < 0 || z < 0 || x >= grid_width || z >= grid_height) {
+		return 0;
+	}
+
+	return clearance[z * grid_width + x];
+}
+
+bool ClearanceMap::CanFit(int x, int z, int size) { return GetClearance(x, z) >= size; }
+int ClearanceMap::GetMaxClearance() { return max_clearance; }
+
+// The square on this tile is one bigger than the smallest square on the tiles next to it and diagonally past it.
+void ClearanceMap::UpdateTile(int x, int z)
+{
+	int index = z * grid_width + x;
+	if (!walkable[index]) {
+		clearance[index] = 0;
+		return;
+	}
+
+	int smallest = glm::min(GetClearance(x + 1, z), glm::min(GetClearance(x, z + 1), GetClearance(x + 1, z + 1)));
+	clearance[index] = glm::min(smallest + 1, max_clearance);
+}
+#pragma endregion
@@ -0,0 +1,504 @@
+/*
+* Implementation of the component store and the systems that run over it. The physics here is the same model the
+* entities always used: gravity, a capped velocity, friction, and a floor at y = 0.
+*/
+#include "headers/ComponentStore.h"
+#include <xmmintrin.h>
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void ComponentStore::Release(void)
+{
+	world_matrices.clear();
+	positions.clear();
+	rotations.clear();
+	sizes.clear();
+	dirty_transforms.clear();
+	dirty_rows.clear();
+	moved_transforms.clear();
+	moved_rows.clear();
+	velocities.clear();
+	accelerations.clear();
+	masses.clear();
+	still_frames.clear();
+	local_mins.clear();
+	local_maxs.clear();
+	aabb_mins.clear();
+	aabb_maxs.clear();
+	for (uint i = 0; i < Component_Count; i++) {
+		members[i].clear();
+		member_positions[i].clear();
+	}
+}
+
+void ComponentStore::Init(void)
+{
+	sleep_velocity = 0.01f;
+	sleep_frames = 30;
+}
+
+ComponentStore::ComponentStore(void) { Init(); }
+
+ComponentStore::ComponentStore(ComponentStore const& other)
+{
+	world_matrices = other.world_matrices;
+	positions = other.positions;
+	rotations = other.rotations;
+	sizes = other.sizes;
+	dirty_transforms = other.dirty_transforms;
+	dirty_rows = other.dirty_rows;
+	moved_transforms = other.moved_transforms;
+	moved_rows = other.moved_rows;
+	velocities = other.velocities;
+	accelerations = other.accelerations;
+	masses = other.masses;
+	still_frames = other.still_frames;
+	sleep_velocity = other.sleep_velocity;
+	sleep_frames = other.sleep_frames;
+	local_mins = other.local_mins;
+	local_maxs = other.local_maxs;
+	aabb_mins = other.aabb_mins;
+	aabb_maxs = other.aabb_maxs;
+	for (uint i = 0; i < Component_Count; i++) {
+		members[i] = other.members[i];
+		member_positions[i] = other.member_positions[i];
+	}
+}
+
+ComponentStore& ComponentStore::operator=(ComponentStore const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		ComponentStore temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+ComponentStore::~ComponentStore() { Release(); }
+
+void ComponentStore::Swap(ComponentStore& other)
+{
+	std::swap(world_matrices, other.world_matrices);
+	std::swap(positions, other.positions);
+	std::swap(rotations, other.rotations);
+	std::swap(sizes, other.sizes);
+	std::swap(dirty_transforms, other.dirty_transforms);
+	std::swap(dirty_rows, other.dirty_rows);
+	std::swap(moved_transforms, other.moved_transforms);
+	std::swap(moved_rows, other.moved_rows);
+	std::swap(velocities, other.velocities);
+	std::swap(accelerations, other.accelerations);
+	std::swap(masses, other.masses);
+	std::swap(still_frames, other.still_frames);
+	std::swap(sleep_velocity, other.sleep_velocity);
+	std::swap(sleep_frames, other.sleep_frames);
+	std::swap(local_mins, other.local_mins);
+	std::swap(local_maxs, other.local_maxs);
+	std::swap(aabb_mins, other.aabb_mins);
+	std::swap(aabb_maxs, other.aabb_maxs);
+	for (uint i = 0; i < Component_Count; i++) {
+		std::swap(members[i], other.members[i]);
+		std::swap(member_positions[i], other.member_positions[i]);
+	}
+}
+#pragma endregion
+
+#pragma region Rows
+void ComponentStore::Reserve(uint row_capacity)
+{
+	world_matrices.reserve(row_capacity);
+	positions.reserve(row_capacity);
+	rotations.reserve(row_capacity);
+	sizes.reserve(row_capacity);
+	dirty_transforms.reserve(row_capacity);
+	moved_transforms.reserve(row_capacity);
+	velocities.reserve(row_capacity);
+	accelerations.reserve(row_capacity);
+	masses.reserve(row_capacity);
+	still_frames.reserve(row_capacity);
+	local_mins.reserve(row_capacity);
+	local_maxs.reserve(row_capacity);
+	aabb_mins.reserve(row_capacity);
+	aabb_maxs.reserve(row_capacity);
+	for (uint i = 0; i < Component_Count; i++) member_positions[i].reserve(row_capacity);
+}
+
+// Get a row ready for a new entity, growing the arrays if the row is new and wiping it if it is being reused.
+void ComponentStore::ResetRow(uint row)
+{
+	if (row >= world_matrices.size()) {
+		uint rowCount = row + 1;
+		world_matrices.resize(rowCount, IDENTITY_M4);
+		positions.resize(rowCount, ZERO_V3);
+		rotations.resize(rowCount, quaternion());
+		sizes.resize(rowCount, vector3(1.0f));
+		dirty_transforms.resize(rowCount, false);
+		moved_transforms.resize(rowCount, false);
+		velocities.resize(rowCount, ZERO_V3);
+		accelerations.resize(rowCount, ZERO_V3);
+		masses.resize(rowCount, 1.0f);
+		still_frames.resize(rowCount, 0);
+		local_mins.resize(rowCount, ZERO_V3);
+		local_maxs.resize(rowCount, ZERO_V3);
+		aabb_mins.resize(rowCount, ZERO_V3);
+		aabb_maxs.resize(rowCount, ZERO_V3);
+		for (uint i = 0; i < Component_Count; i++) member_positions[i].resize(rowCount, -1);
+	}
+
+	ClearRow(row);
+	world_matrices[row] = IDENTITY_M4;
+	positions[row] = ZERO_V3;
+	rotations[row] = quaternion();
+	sizes[row] = vector3(1.0f);
+	dirty_transforms[row] = false;
+	moved_transforms[row] = false;
+	velocities[row] = ZERO_V3;
+	accelerations[row] = ZERO_V3;
+	masses[row] = 1.0f;
+	still_frames[row] = 0;
+	local_mins[row] = local_maxs[row] = ZERO_V3;
+	aabb_mins[row] = aabb_maxs[row] = ZERO_V3;
+}
+
+void ComponentStore::ClearRow(uint row)
+{
+	for (int i = 0; i < Component_Count; i++) RemoveComponent(row, i);
+}
+
+void ComponentStore::AddComponent(uint row, int component)
+{
+	if (HasComponent(row, component)) return;
+
+	member_positions[component][row] = members[component].size();
+	members[component].push_back(row);
+}
+
+// Move the last member into the gap so the member list stays packed.
+void ComponentStore::RemoveComponent(uint row, int component)
+{
+	if (!HasComponent(row, component)) return;
+
+	int position = member_positions[component][row];
+	uint lastRow = members[component].back();
+	members[component][position] = lastRow;
+	member_positions[component][lastRow] = position;
+	members[component].pop_back();
+	member_positions[component][row] = -1;
+}
+
+bool ComponentStore::HasComponent(uint row, int component)
+{
+	return row < member_positions[component].size() && member_positions[component][row] != -1;
+}
+
+std::vector<uint> const& ComponentStore::GetMembers(int component) { return members[component]; }
+
+int ComponentStore::GetMotionState(uint row)
+{
+	if (!HasComponent(row, Component_Physics)) return MotionState_Static;
+	return HasComponent(row, Component_Awake) ? MotionState_Awake : MotionState_Sleeping;
+}
+
+// Anything that moves a body or pushes on it wakes it back up. Static entities have nothing to wake.
+void ComponentStore::WakeUp(uint row)
+{
+	if (!HasComponent(row, Component_Physics)) return;
+
+	AddComponent(row, Component_Awake);
+	still_frames[row] = 0;
+}
+
+void ComponentStore::SetSleepSettings(float velocity, uint frames)
+{
+	sleep_velocity = velocity;
+	sleep_frames = frames;
+}
+#pragma endregion
+
+#pragma region Component Data
+matrix4 ComponentStore::GetWorldMatrix(uint row)
+{
+	RefreshTransform(row);
+	return world_matrices[row];
+}
+
+// Take an arbitrary matrix apart into position, rotation and scale. This is for callers that only have a matrix,
+// anything that moves every frame should call SetTransform instead. glm::decompose hands back the inverse rotation in
+// the glm we ship, so the columns are taken apart by hand.
+void ComponentStore::SetWorldMatrix(uint row, matrix4 world_matrix)
+{
+	vector3 translation = vector3(world_matrix[3]);
+
+	glm::mat3 basis = glm::mat3(world_matrix);
+	vector3 scale = vector3(glm::length(basis[0]), glm::length(basis[1]), glm::length(basis[2]));
+
+	// A mirrored matrix keeps its flip in the scale so what is left over is a proper rotation.
+	if (glm::determinant(basis) < 0.0f) scale.x = -scale.x;
+
+	for (uint i = 0; i < 3; i++) {
+		if (scale[i] != 0.0f) basis[i] /= scale[i];
+	}
+
+	SetTransform(row, translation, glm::normalize(glm::quat_cast(basis)), scale);
+}
+
+void ComponentStore::SetTransform(uint row, vector3 position, quaternion rotation, vector3 size)
+{
+	positions[row] = position;
+	rotations[row] = rotation;
+	sizes[row] = size;
+	MarkDirty(row);
+	WakeUp(row);
+}
+
+vector3 ComponentStore::GetPosition(uint row) { return positions[row]; }
+void ComponentStore::SetPosition(uint row, vector3 position)
+{
+	positions[row] = position;
+	MarkDirty(row);
+	WakeUp(row);
+}
+
+quaternion ComponentStore::GetRotation(uint row) { return rotations[row]; }
+void ComponentStore::SetRotation(uint row, quaternion rotation)
+{
+	rotations[row] = rotation;
+	MarkDirty(row);
+	WakeUp(row);
+}
+
+vector3 ComponentStore::GetSize(uint row) { return sizes[row]; }
+vector3 ComponentStore::GetVelocity(uint row) { return velocities[row]; }
+void ComponentStore::SetVelocity(uint row, vector3 velocity)
+{
+	velocities[row] = velocity;
+	WakeUp(row);
+}
+
+float ComponentStore::GetMass(uint row) { return masses[row]; }
+void ComponentStore::SetMass(uint row, float mass) { masses[row] = mass; }
+
+void ComponentStore::ApplyForce(uint row, vector3 force)
+{
+	if (masses[row] < 0.01f) {
+		masses[row] = 0.01f;
+	}
+
+	accelerations[row] += force / masses[row];
+	WakeUp(row);
+}
+
+void ComponentStore::SetLocalBounds(uint row, vector3 local_min, vector3 local_max)
+{
+	local_mins[row] = local_min;
+	local_maxs[row] = local_max;
+	RefreshTransform(row);
+	UpdateBounds(row);
+}
+
+vector3 ComponentStore::GetBoundsMin(uint row)
+{
+	RefreshTransform(row);
+	return aabb_mins[row];
+}
+
+vector3 ComponentStore::GetBoundsMax(uint row)
+{
+	RefreshTransform(row);
+	return aabb_maxs[row];
+}
+
+// Queue a row for the next transform pass, once no matter how often it moves before then.
+void ComponentStore::MarkDirty(uint row)
+{
+	if (dirty_transforms[row]) return;
+
+	dirty_transforms[row] = true;
+	dirty_rows.push_back(row);
+}
+
+// Rebuild the world matrix and bounds of a row that moved since they were last built.
+void ComponentStore::RefreshTransform(uint row)
+{
+	if (!dirty_transforms[row]) return;
+
+	world_matrices[row] = glm::translate(positions[row]) * glm::mat4_cast(rotations[row]) * glm::scale(sizes[row]);
+	if (HasComponent(row, Component_Collider)) UpdateBounds(row);
+	dirty_transforms[row] = false;
+
+	if (!moved_transforms[row]) {
+		moved_transforms[row] = true;
+		moved_rows.push_back(row);
+	}
+}
+#pragma endregion
+
+#pragma region Systems
+vector3 CalculateMaxVelocity(vector3 velocity, float max_velocity)
+{
+	if (glm::length(velocity) > max_velocity) {
+		velocity = glm::normalize(velocity);
+		velocity *= max_velocity;
+	}
+	return velocity;
+}
+vector3 RoundSmallVelocity(vector3 velocity, float min_velocity = 0.01f)
+{
+	if (glm::length(velocity) < min_velocity) {
+		velocity = ZERO_V3;
+	}
+	return velocity;
+}
+
+// Rebuild every transform that moved, so nothing read afterwards has to check. Only the queued rows are visited,
+// some of them may already have been rebuilt by a read in the meantime.
+void ComponentStore::UpdateTransforms(void)
+{
+	for (uint i = 0; i < dirty_rows.size(); i++) {
+		RefreshTransform(dirty_rows[i]);
+	}
+	dirty_rows.clear();
+}
+
+// Rows that got a new world matrix since the last ClearMovedRows.
+std::vector<uint> const& ComponentStore::GetMovedRows(void) { return moved_rows; }
+
+void ComponentStore::ClearMovedRows(void)
+{
+	for (uint i = 0; i < moved_rows.size(); i++) {
+		if (moved_rows[i] < moved_transforms.size()) moved_transforms[moved_rows[i]] = false;
+	}
+	moved_rows.clear();
+}
+
+// Step every awake body. Only the position is written, the matrix and bounds follow when they are next read. Walked
+// backwards because a body that falls asleep swaps the last awake body into its place.
+void ComponentStore::IntegratePhysics(void)
+{
+	std::vector<uint> const& awakeRows = members[Component_Awake];
+	for (uint i = awakeRows.size(); i > 0; i--) {
+		IntegratePhysics(awakeRows[i - 1]);
+	}
+}
+
+void ComponentStore::IntegratePhysics(uint row)
+{
+	// Gravity, added straight to the acceleration so it doesn't count as a push that keeps the body awake.
+	if (masses[row] < 0.01f) {
+		masses[row] = 0.01f;
+	}
+	accelerations[row] += vector3(0.0f, -0.035f, 0.0f) / masses[row];
+
+	vector3 velocity = velocities[row] + accelerations[row];
+	velocity = CalculateMaxVelocity(velocity, 5.0f);
+
+	// Friction.
+	velocity *= 1.0f - 0.1f;
+	if (glm::length(velocity) < 0.01f) {
+		velocity = ZERO_V3;
+	}
+	velocity = RoundSmallVelocity(velocity, 0.028f);
+
+	vector3 position = positions[row] + velocity;
+	if (position.y <= 0) {
+		position.y = 0;
+		velocity.y = 0;
+	}
+
+	if (position != positions[row]) {
+		positions[row] = position;
+		MarkDirty(row);
+	}
+	velocities[row] = velocity;
+	accelerations[row] = ZERO_V3;
+
+	// A body that has stayed this slow for long enough goes to sleep where it is.
+	if (glm::length(velocity) < sleep_velocity) still_frames[row]++;
+	else still_frames[row] = 0;
+
+	if (still_frames[row] >= sleep_frames) {
+		velocities[row] = ZERO_V3;
+		RemoveComponent(row, Component_Awake);
+	}
+}
+
+void ComponentStore::UpdateBounds(void)
+{
+	std::vector<uint> const& colliderRows = members[Component_Collider];
+	for (uint i = 0; i < colliderRows.size(); i++) {
+		RefreshTransform(colliderRows[i]);
+		UpdateBounds(colliderRows[i]);
+	}
+}
+
+// World space box around the local box. The center moves with the matrix and the extents are the absolute value of
+// the matrix applied to the half size, which is the same box as placing all 8 corners but without the corners. Each
+// matrix column is one SSE register, so all three axes are done at once.
+void ComponentStore::UpdateBounds(uint row)
+{
+	vector3 v3Center = (local_mins[row] + local_maxs[row]) * 0.5f;
+	vector3 v3Half = (local_maxs[row] - local_mins[row]) * 0.5f;
+
+	const float* fWorld = &world_matrices[row][0][0];
+	__m128 v4Columns[4];
+	for (uint i = 0; i < 4; i++) v4Columns[i] = _mm_loadu_ps(fWorld + i * 4);
+
+	__m128 v4Zero = _mm_setzero_ps();
+	__m128 v4WorldCenter = v4Columns[3];
+	__m128 v4WorldHalf = v4Zero;
+	for (uint axis = 0; axis < 3; axis++) {
+		__m128 v4Column = v4Columns[axis];
+		__m128 v4AbsColumn = _mm_max_ps(v4Column, _mm_sub_ps(v4Zero, v4Column));
+		v4WorldCenter = _mm_add_ps(v4WorldCenter, _mm_mul_ps(v4Column, _mm_set1_ps(v3Center[axis])));
+		v4WorldHalf = _mm_add_ps(v4WorldHalf, _mm_mul_ps(v4AbsColumn, _mm_set1_ps(v3Half[axis])));
+	}
+
+	float fMin[4], fMax[4];
+	_mm_storeu_ps(fMin, _mm_sub_ps(v4WorldCenter, v4WorldHalf));
+	_mm_storeu_ps(fMax, _mm_add_ps(v4WorldCenter, v4WorldHalf));
+	aabb_mins[row] = vector3(fMin[0], fMin[1], fMin[2]);
+	aabb_maxs[row] = vector3(fMax[0], fMax[1], fMax[2]);
+}
+
+bool ComponentStore::Overlaps(uint row, uint other_row)
+{
+	RefreshTransform(row);
+	RefreshTransform(other_row);
+
+	vector3 const& v3Min = aabb_mins[row];
+	vector3 const& v3Max = aabb_maxs[row];
+	vector3 const& v3OtherMin = aabb_mins[other_row];
+	vector3 const& v3OtherMax = aabb_maxs[other_row];
+
+	return v3Max.x >= v3OtherMin.x && v3Min.x <= v3OtherMax.x &&
+		v3Max.y >= v3OtherMin.y && v3Min.y <= v3OtherMax.y &&
+		v3Max.z >= v3OtherMin.z && v3Min.z <= v3OtherMax.z;
+}
+
+// Moving things push each other along their velocity, resting things are nudged apart.
+void ComponentStore::ResolveCollision(uint row, uint other_row)
+{
+	float fMagThis = glm::length(velocities[row]);
+	float fMagOther = glm::length(velocities[other_row]);
+
+	if (fMagThis > 0.015f || fMagOther > 0.015f) {
+		vector3 v3Velocity = velocities[row];
+		ApplyForce(row, -v3Velocity);
+		ApplyForce(other_row, v3Velocity);
+	} else {
+		vector3 v3Direction = positions[row] - positions[other_row];
+
+		if (glm::length(v3Direction) != 0) {
+			v3Direction = glm::normalize(v3Direction);
+		}
+
+		v3Direction *= 0.04f;
+		ApplyForce(row, v3Direction);
+		ApplyForce(other_row, -v3Direction);
+	}
+}
+#pragma endregion
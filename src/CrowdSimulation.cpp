@@ -0,0 +1,417 @@
+/*
+* Implementation of the crowd layer. The ORCA solve follows van den Berg et al, "Reciprocal n-Body Collision
+* Avoidance": each neighbour turns into a half plane of allowed velocities and a small linear program picks the allowed
+* velocity closest to the preferred one.
+*/
+#include "headers/CrowdSimulation.h"
+#include <algorithm>
+#include <thread>
+
+using namespace Simplex;
+
+// 2D cross product, positive when b is counter clockwise from a.
+float CrossProduct2(vector2 a, vector2 b) { return a.x * b.y - a.y * b.x; }
+
+#pragma region Constructors / Destructors
+void CrowdSimulation::Release(void)
+{
+	positions.clear();
+	velocities.clear();
+	preferred_velocities.clear();
+	new_velocities.clear();
+	radii.clear();
+	max_speeds.clear();
+	agent_cells.clear();
+	cell_starts.clear();
+	sorted_agents.clear();
+}
+
+void CrowdSimulation::Init(void)
+{
+	neighbor_distance = 2.0f;
+	time_horizon = 1.0f;
+	max_neighbors = 10;
+	worker_count = glm::max(std::thread::hardware_concurrency(), 1u);
+	time_step = 0.0f;
+	table_size = 0;
+}
+
+CrowdSimulation::CrowdSimulation(float neighbor_distance, float time_horizon, uint max_neighbors)
+{
+	Init();
+	this->neighbor_distance = neighbor_distance;
+	this->time_horizon = time_horizon;
+	this->max_neighbors = max_neighbors;
+}
+
+CrowdSimulation::CrowdSimulation(CrowdSimulation const& other)
+{
+	neighbor_distance = other.neighbor_distance;
+	time_horizon = other.time_horizon;
+	max_neighbors = other.max_neighbors;
+	worker_count = other.worker_count;
+	positions = other.positions;
+	velocities = other.velocities;
+	preferred_velocities = other.preferred_velocities;
+	new_velocities = other.new_velocities;
+	radii = other.radii;
+	max_speeds = other.max_speeds;
+	time_step = other.time_step;
+	table_size = other.table_size;
+	agent_cells = other.agent_cells;
+	cell_starts = other.cell_starts;
+	sorted_agents = other.sorted_agents;
+}
+
+CrowdSimulation& CrowdSimulation::operator=(CrowdSimulation const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		CrowdSimulation temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+CrowdSimulation::~CrowdSimulation() { Release(); }
+
+void CrowdSimulation::Swap(CrowdSimulation& other)
+{
+	std::swap(neighbor_distance, other.neighbor_distance);
+	std::swap(time_horizon, other.time_horizon);
+	std::swap(max_neighbors, other.max_neighbors);
+	std::swap(worker_count, other.worker_count);
+	std::swap(positions, other.positions);
+	std::swap(velocities, other.velocities);
+	std::swap(preferred_velocities, other.preferred_velocities);
+	std::swap(new_velocities, other.new_velocities);
+	std::swap(radii, other.radii);
+	std::swap(max_speeds, other.max_speeds);
+	std::swap(time_step, other.time_step);
+	std::swap(table_size, other.table_size);
+	std::swap(agent_cells, other.agent_cells);
+	std::swap(cell_starts, other.cell_starts);
+	std::swap(sorted_agents, other.sorted_agents);
+}
+#pragma endregion
+
+#pragma region Agents
+uint CrowdSimulation::AddAgent(vector2 position, float radius, float max_speed)
+{
+	positions.push_back(position);
+	velocities.push_back(vector2());
+	preferred_velocities.push_back(vector2());
+	new_velocities.push_back(vector2());
+	radii.push_back(radius);
+	max_speeds.push_back(max_speed);
+	return positions.size() - 1;
+}
+
+uint CrowdSimulation::GetAgentCount(void) { return positions.size(); }
+void CrowdSimulation::SetPreferredVelocity(uint agent, vector2 velocity) { preferred_velocities[agent] = velocity; }
+vector2 CrowdSimulation::GetPosition(uint agent) { return positions[agent]; }
+vector2 CrowdSimulation::GetVelocity(uint agent) { return velocities[agent]; }
+
+// Teleport an agent. It forgets its old velocity so its neighbours don't expect it to keep going.
+void CrowdSimulation::SetPosition(uint agent, vector2 position)
+{
+	positions[agent] = position;
+	velocities[agent] = vector2();
+}
+#pragma endregion
+
+#pragma region Spatial Hash
+uint CrowdSimulation::HashCell(int x, int z)
+{
+	return ((uint)x * 73856093u ^ (uint)z * 19349663u) & (table_size - 1);
+}
+
+// Counting sort of the agents by hash bucket, so each bucket is one run of sorted_agents.
+void CrowdSimulation::BuildSpatialHash(void)
+{
+	uint agentCount = positions.size();
+
+	table_size = 64;
+	while (table_size < agentCount * 2) table_size *= 2;
+
+	agent_cells.resize(agentCount);
+	cell_starts.assign(table_size + 1, 0);
+	sorted_agents.resize(agentCount);
+
+	for (uint i = 0; i < agentCount; i++) {
+		int cellX = (int)glm::floor(positions[i].x / neighbor_distance);
+		int cellZ = (int)glm::floor(positions[i].y / neighbor_distance);
+		agent_cells[i] = HashCell(cellX, cellZ);
+		cell_starts[agent_cells[i] + 1]++;
+	}
+
+	for (uint i = 0; i < table_size; i++) {
+		cell_starts[i + 1] += cell_starts[i];
+	}
+
+	std::vector<uint> cellFill(cell_starts.begin(), cell_starts.end() - 1);
+	for (uint i = 0; i < agentCount; i++) {
+		sorted_agents[cellFill[agent_cells[i]]++] = i;
+	}
+}
+
+// The closest max_neighbors agents within neighbor_distance.
+void CrowdSimulation::FindNeighbors(uint agent, std::vector<uint>& neighbors)
+{
+	neighbors.clear();
+
+	vector2 position = positions[agent];
+	float rangeSquared = neighbor_distance * neighbor_distance;
+	// Cells are neighbor_distance wide, so everyone in range sits in the ring of cells around our own. Working out the
+	// ring from our own cell keeps it at 3x3, rounding the range ends separately can stretch it to four cells.
+	int centerX = (int)glm::floor(position.x / neighbor_distance);
+	int centerZ = (int)glm::floor(position.y / neighbor_distance);
+
+	// Different cells can land in the same bucket, only read each bucket once.
+	uint visited[9];
+	uint visitedCount = 0;
+
+	for (int cellX = centerX - 1; cellX <= centerX + 1; cellX++) {
+		for (int cellZ = centerZ - 1; cellZ <= centerZ + 1; cellZ++) {
+			uint cell = HashCell(cellX, cellZ);
+			if (std::find(visited, visited + visitedCount, cell) != visited + visitedCount) continue;
+			visited[visitedCount++] = cell;
+
+			for (uint i = cell_starts[cell]; i < cell_starts[cell + 1]; i++) {
+				uint other = sorted_agents[i];
+				if (other == agent) continue;
+
+				vector2 offset = positions[other] - position;
+				if (glm::dot(offset, offset) < rangeSquared) neighbors.push_back(other);
+			}
+		}
+	}
+
+	if (neighbors.size() > max_neighbors) {
+		std::nth_element(neighbors.begin(), neighbors.begin() + max_neighbors, neighbors.end(),
+			[this, position](uint a, uint b) {
+				vector2 offsetA = positions[a] - position;
+				vector2 offsetB = positions[b] - position;
+				return glm::dot(offsetA, offsetA) < glm::dot(offsetB, offsetB);
+			});
+		neighbors.resize(max_neighbors);
+	}
+}
+#pragma endregion
+
+#pragma region Simulation
+// Work out every agent's avoiding velocity, split across the workers, and only then move everyone. The workers only
+// read the last frame's positions and velocities and each writes its own slice of new_velocities.
+void CrowdSimulation::Update(float delta)
+{
+	uint agentCount = positions.size();
+	if (agentCount == 0 || delta <= 0.0f) return;
+
+	time_step = delta;
+	BuildSpatialHash();
+	new_velocities.resize(agentCount);
+
+	// Not worth waking a thread for a handful of agents.
+	uint workers = glm::max(glm::min(worker_count, agentCount / 256), 1u);
+	uint sliceSize = (agentCount + workers - 1) / workers;
+
+	std::vector<std::thread> threads;
+	for (uint worker = 1; worker < workers; worker++) {
+		uint begin = worker * sliceSize;
+		uint end = glm::min(begin + sliceSize, agentCount);
+		threads.push_back(std::thread(&CrowdSimulation::ComputeNewVelocities, this, begin, end));
+	}
+	ComputeNewVelocities(0, glm::min(sliceSize, agentCount));
+
+	for (uint i = 0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+
+	for (uint i = 0; i < agentCount; i++) {
+		velocities[i] = new_velocities[i];
+		positions[i] += velocities[i] * delta;
+	}
+}
+
+void CrowdSimulation::ComputeNewVelocities(uint begin, uint end)
+{
+	std::vector<uint> neighbors;
+	std::vector<Line> lines;
+
+	for (uint i = begin; i < end; i++) {
+		ComputeNewVelocity(i, neighbors, lines);
+	}
+}
+
+// Each neighbour rules out the velocities that would hit it within time_horizon. We take half the responsibility for
+// dodging, trusting the neighbour to take the other half.
+void CrowdSimulation::ComputeNewVelocity(uint agent, std::vector<uint>& neighbors, std::vector<Line>& lines)
+{
+	FindNeighbors(agent, neighbors);
+	lines.clear();
+
+	vector2 position = positions[agent];
+	vector2 velocity = velocities[agent];
+	float inverseTimeHorizon = 1.0f / time_horizon;
+
+	for (uint i = 0; i < neighbors.size(); i++) {
+		uint other = neighbors[i];
+		vector2 relativePosition = positions[other] - position;
+		vector2 relativeVelocity = velocity - velocities[other];
+		float distanceSquared = glm::dot(relativePosition, relativePosition);
+		float combinedRadius = radii[agent] + radii[other];
+		float combinedRadiusSquared = combinedRadius * combinedRadius;
+
+		Line line;
+		vector2 u;
+
+		if (distanceSquared > combinedRadiusSquared) {
+			// No collision yet. Push the relative velocity out of the truncated cone.
+			vector2 w = relativeVelocity - inverseTimeHorizon * relativePosition;
+			float wLengthSquared = glm::dot(w, w);
+			float dotProduct = glm::dot(w, relativePosition);
+
+			if (dotProduct < 0.0f && dotProduct * dotProduct > combinedRadiusSquared * wLengthSquared) {
+				// Closest to the rounded front of the cone.
+				float wLength = glm::sqrt(wLengthSquared);
+				vector2 unitW = w / wLength;
+				line.direction = vector2(unitW.y, -unitW.x);
+				u = (combinedRadius * inverseTimeHorizon - wLength) * unitW;
+			} else {
+				// Closest to one of the sides of the cone.
+				float leg = glm::sqrt(distanceSquared - combinedRadiusSquared);
+				if (CrossProduct2(relativePosition, w) > 0.0f) {
+					line.direction = vector2(relativePosition.x * leg - relativePosition.y * combinedRadius,
+						relativePosition.x * combinedRadius + relativePosition.y * leg) / distanceSquared;
+				} else {
+					line.direction = -vector2(relativePosition.x * leg + relativePosition.y * combinedRadius,
+						-relativePosition.x * combinedRadius + relativePosition.y * leg) / distanceSquared;
+				}
+
+				u = glm::dot(relativeVelocity, line.direction) * line.direction - relativeVelocity;
+			}
+		} else {
+			// Already overlapping. Get apart within this frame.
+			float inverseTimeStep = 1.0f / time_step;
+			vector2 w = relativeVelocity - inverseTimeStep * relativePosition;
+			float wLength = glm::length(w);
+			vector2 unitW = wLength > 0.0f ? w / wLength : vector2(1.0f, 0.0f);
+			line.direction = vector2(unitW.y, -unitW.x);
+			u = (combinedRadius * inverseTimeStep - wLength) * unitW;
+		}
+
+		line.point = velocity + 0.5f * u;
+		lines.push_back(line);
+	}
+
+	vector2 result;
+	uint failedLine = LinearProgram2(lines, max_speeds[agent], preferred_velocities[agent], false, result);
+	if (failedLine < lines.size()) LinearProgram3(lines, failedLine, max_speeds[agent], result);
+
+	new_velocities[agent] = result;
+}
+
+// Best velocity on one constraint line that still satisfies every line before it.
+bool CrowdSimulation::LinearProgram1(std::vector<Line> const& lines, uint line_number, float radius, vector2 optimal, bool direction_optimal, vector2& result)
+{
+	Line const& line = lines[line_number];
+	float dotProduct = glm::dot(line.point, line.direction);
+	float discriminant = dotProduct * dotProduct + radius * radius - glm::dot(line.point, line.point);
+
+	// The line misses the max speed circle.
+	if (discriminant < 0.0f) return false;
+
+	float discriminantRoot = glm::sqrt(discriminant);
+	float tLeft = -dotProduct - discriminantRoot;
+	float tRight = -dotProduct + discriminantRoot;
+
+	for (uint i = 0; i < line_number; i++) {
+		float denominator = CrossProduct2(line.direction, lines[i].direction);
+		float numerator = CrossProduct2(lines[i].direction, line.point - lines[i].point);
+
+		if (glm::abs(denominator) <= 0.00001f) {
+			// Parallel lines.
+			if (numerator < 0.0f) return false;
+			continue;
+		}
+
+		float t = numerator / denominator;
+		if (denominator >= 0.0f) tRight = glm::min(tRight, t);
+		else tLeft = glm::max(tLeft, t);
+
+		if (tLeft > tRight) return false;
+	}
+
+	if (direction_optimal) {
+		result = line.point + (glm::dot(optimal, line.direction) > 0.0f ? tRight : tLeft) * line.direction;
+	} else {
+		float t = glm::clamp(glm::dot(line.direction, optimal - line.point), tLeft, tRight);
+		result = line.point + t * line.direction;
+	}
+
+	return true;
+}
+
+// Velocity closest to the optimal one inside every half plane and the max speed circle. Returns the index of the line
+// that made it impossible, or the line count when it worked.
+uint CrowdSimulation::LinearProgram2(std::vector<Line> const& lines, float radius, vector2 optimal, bool direction_optimal, vector2& result)
+{
+	if (direction_optimal) {
+		result = optimal * radius;
+	} else if (glm::dot(optimal, optimal) > radius * radius) {
+		result = glm::normalize(optimal) * radius;
+	} else {
+		result = optimal;
+	}
+
+	for (uint i = 0; i < lines.size(); i++) {
+		if (CrossProduct2(lines[i].direction, lines[i].point - result) > 0.0f) {
+			vector2 previousResult = result;
+			if (!LinearProgram1(lines, i, radius, optimal, direction_optimal, result)) {
+				result = previousResult;
+				return i;
+			}
+		}
+	}
+
+	return lines.size();
+}
+
+// Too crowded for every half plane to hold. Find the velocity that breaks them the least.
+void CrowdSimulation::LinearProgram3(std::vector<Line> const& lines, uint begin_line, float radius, vector2& result)
+{
+	float distance = 0.0f;
+
+	for (uint i = begin_line; i < lines.size(); i++) {
+		if (CrossProduct2(lines[i].direction, lines[i].point - result) <= distance) continue;
+
+		std::vector<Line> projectedLines;
+		for (uint j = 0; j < i; j++) {
+			Line line;
+			float determinant = CrossProduct2(lines[i].direction, lines[j].direction);
+
+			if (glm::abs(determinant) <= 0.00001f) {
+				if (glm::dot(lines[i].direction, lines[j].direction) > 0.0f) continue;
+				line.point = 0.5f * (lines[i].point + lines[j].point);
+			} else {
+				line.point = lines[i].point + (CrossProduct2(lines[j].direction, lines[i].point - lines[j].point) / determinant) * lines[i].direction;
+			}
+
+			line.direction = glm::normalize(lines[j].direction - lines[i].direction);
+			projectedLines.push_back(line);
+		}
+
+		vector2 previousResult = result;
+		if (LinearProgram2(projectedLines, radius, vector2(-lines[i].direction.y, lines[i].direction.x), true, result) < projectedLines.size()) {
+			result = previousResult;
+		}
+
+		distance = CrossProduct2(lines[i].direction, lines[i].point - result);
+	}
+}
+
+void CrowdSimulation::SetWorkerCount(uint workers) { worker_count = glm::max(workers, 1u); }
+uint CrowdSimulation::GetWorkerCount(void) { return worker_count; }
+#pragma endregion
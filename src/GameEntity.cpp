@@ -5,40 +5,47 @@
 
 using namespace Simplex;
 
-std::map<String, GameEntity*> GameEntity::id_to_entity;
-
 #pragma region Constructor / Destructor
-Simplex::GameEntity::GameEntity(String model_file, String unique_id)
+Simplex::GameEntity::GameEntity(ModelCache* model_cache, uint model_asset, String unique_id, ComponentStore* components, uint component_row)
 {
 	Init();
-	model = new Model();
-	model->Load(model_file);
-
-	if (model->GetName() != "") {
-		GenUniqueID(unique_id);
-		id = unique_id;
-		id_to_entity[unique_id] = this;
-		rigid_body = new ObjectRigidBody(model->GetVertexList());
-		entity_model_loaded_in_memory = true;
+	ModelAsset const& asset = model_cache->GetAsset(model_asset);
+	if (asset.state == ModelAssetState_Failed) {
+		return;
 	}
 
-	physics = new ObjectPhysics();
+	// The model is shared with every other entity made from the same file and may still be loading, we look it up
+	// whenever we draw. Its bounds were worked out once for the model, so the rigid body is built from them directly.
+	id = unique_id;
+	this->model_cache = model_cache;
+	this->model_asset = model_asset;
+	rigid_body = new ObjectRigidBody(asset.local_min, asset.local_max);
+	entity_model_loaded_in_memory = true;
+
+	// Transform, physics and bounds live in the manager's component store, the entity only knows its row.
+	this->components = components;
+	this->component_row = component_row;
+	components->ResetRow(component_row);
+	components->AddComponent(component_row, Component_Transform);
+	components->AddComponent(component_row, Component_Collider);
+	components->AddComponent(component_row, Component_Render);
+	components->SetLocalBounds(component_row, asset.local_min, asset.local_max);
 }
 
 Simplex::GameEntity::GameEntity(GameEntity const& other)
 {
 	entity_model_loaded_in_memory = other.entity_model_loaded_in_memory;
-	model = other.model;
-	is_rigid_body_disabled = other.is_rigid_body_disabled;
+	model_cache = other.model_cache;
+	model_asset = other.model_asset;
 	is_model_rendering_disabled = other.is_model_rendering_disabled;
-	rigid_body = new ObjectRigidBody(model->GetVertexList());
-	world_matrix = other.world_matrix;
+	rigid_body = new ObjectRigidBody(other.rigid_body->GetMinLocal(), other.rigid_body->GetMaxLocal());
 	mesh_manager = other.mesh_manager;
 	id = other.id;
 	should_render_axis = other.should_render_axis;
 	exists_in_dimensions_count = other.exists_in_dimensions_count;
 	dimensions_lives_in = other.dimensions_lives_in;
-	physics = new ObjectPhysics(*other.physics);
+	components = other.components;
+	component_row = other.component_row;
 }
 GameEntity& Simplex::GameEntity::operator=(GameEntity const& other)
 {
@@ -56,35 +63,35 @@ GameEntity::~GameEntity() { Release(); }
 void Simplex::GameEntity::Swap(GameEntity& other)
 {
 	entity_model_loaded_in_memory = false;
-	std::swap(model, other.model);
+	std::swap(model_cache, other.model_cache);
+	std::swap(model_asset, other.model_asset);
 	std::swap(is_model_rendering_disabled, other.is_model_rendering_disabled);
-	std::swap(is_rigid_body_disabled, other.is_rigid_body_disabled);
 	std::swap(rigid_body, other.rigid_body);
-	std::swap(world_matrix, other.world_matrix);
 	std::swap(mesh_manager, other.mesh_manager);
 	std::swap(entity_model_loaded_in_memory, other.entity_model_loaded_in_memory);
 	std::swap(id, other.id);
 	std::swap(should_render_axis, other.should_render_axis);
 	std::swap(exists_in_dimensions_count, other.exists_in_dimensions_count);
 	std::swap(dimensions_lives_in, other.dimensions_lives_in);
-	std::swap(physics, other.physics);
+	std::swap(components, other.components);
+	std::swap(component_row, other.component_row);
 }
 
 bool Simplex::GameEntity::IsInitialized(void) { return entity_model_loaded_in_memory; }
 
 void Simplex::GameEntity::Release(void)
 {
-	// The mesh manager will release the model of the entity.
+	// The model belongs to the manager's model cache.
 	mesh_manager = nullptr;
-	model = nullptr;
+	model_cache = nullptr;
 	if (dimensions_lives_in)
 	{
 		delete[] dimensions_lives_in;
 		dimensions_lives_in = nullptr;
 	}
 	SafeDelete(rigid_body);
-	SafeDelete(physics);
-	id_to_entity.erase(id);
+	if (components) components->ClearRow(component_row);
+	components = nullptr;
 }
 
 void Simplex::GameEntity::Init(void)
@@ -93,51 +100,21 @@ void Simplex::GameEntity::Init(void)
 	entity_model_loaded_in_memory = false;
 	should_render_axis = false;
 	is_model_rendering_disabled = false;
-	is_rigid_body_disabled = false;
-	model = nullptr;
+	model_cache = nullptr;
+	model_asset = 0;
 	rigid_body = nullptr;
 	dimensions_lives_in = nullptr;
-	world_matrix = IDENTITY_M4;
 	id = "";
 	exists_in_dimensions_count = 0;
-	should_use_physics = false;
-	physics = nullptr;
+	components = nullptr;
+	component_row = 0;
 }
 
 #pragma endregion
 
 #pragma region Game State
-void Simplex::GameEntity::Update(void)
-{
-	if (should_use_physics) {
-		physics->Update();
-		SetModelMatrix(glm::translate(physics->GetPosition()) * glm::scale(physics->GetSize()));
-	}
-}
-
-GameEntity* Simplex::GameEntity::GetEntity(String unique_id)
-{
-	//look the entity based on the unique id
-	auto entity = id_to_entity.find(unique_id);
-	//if not found return nullptr, if found return it
-	return entity == id_to_entity.end() ? nullptr : entity->second;
-}
-
-void Simplex::GameEntity::GenUniqueID(String& unique_id)
-{
-	static uint index = 0;
-	String sName = unique_id;
-	GameEntity* pEntity = GetEntity(unique_id);
-
-	while (pEntity) {
-		unique_id = sName + "_" + std::to_string(index);
-		index++;
-		pEntity = GetEntity(unique_id);
-	}
-	return;
-}
-
 String Simplex::GameEntity::GetUniqueID(void) { return id; }
+uint Simplex::GameEntity::GetComponentRow(void) { return component_row; }
 #pragma endregion
 
 #pragma region Collision
@@ -239,7 +216,8 @@ bool Simplex::GameEntity::IsColliding(GameEntity* const other)
 	}
 
 
-	if (is_rigid_body_disabled || other->is_rigid_body_disabled) {
+	if (!components->HasComponent(component_row, Component_Collider) ||
+		!other->components->HasComponent(other->component_row, Component_Collider)) {
 		return false;
 	}
 
@@ -247,13 +225,22 @@ bool Simplex::GameEntity::IsColliding(GameEntity* const other)
 		return false;
 	}
 
-	return rigid_body->IsColliding(other->GetRigidBody());
+	// The bounds come from the component store, the rigid bodies only keep track of who touches whom.
+	bool bColliding = components->Overlaps(component_row, other->component_row);
+	if (bColliding) {
+		rigid_body->AddCollisionWith(other->rigid_body);
+		other->rigid_body->AddCollisionWith(rigid_body);
+	} else {
+		rigid_body->RemoveCollisionWith(other->rigid_body);
+		other->rigid_body->RemoveCollisionWith(rigid_body);
+	}
+	return bColliding;
 }
 
 void Simplex::GameEntity::ResolveCollision(GameEntity* other_entity)
 {
-	if (should_use_physics) {
-		physics->ResolveCollision(other_entity->GetSolver());
+	if (components->HasComponent(component_row, Component_Physics)) {
+		components->ResolveCollision(component_row, other_entity->component_row);
 	}
 }
 
@@ -267,60 +254,44 @@ void Simplex::GameEntity::ClearCollisionList(void)
 #pragma endregion
 
 #pragma region Physics
-void Simplex::GameEntity::ApplyForce(vector3 force)
-{
-	physics->ApplyForce(force);
-}
+void Simplex::GameEntity::ApplyForce(vector3 force) { components->ApplyForce(component_row, force); }
+void Simplex::GameEntity::SetPosition(vector3 position) { components->SetPosition(component_row, position); }
+Simplex::vector3 Simplex::GameEntity::GetPosition(void) { return components->GetPosition(component_row); }
+void Simplex::GameEntity::SetVelocity(vector3 velocity) { components->SetVelocity(component_row, velocity); }
+Simplex::vector3 Simplex::GameEntity::GetVelocity(void) { return components->GetVelocity(component_row); }
+void Simplex::GameEntity::SetMass(float mass) { components->SetMass(component_row, mass); }
+float Simplex::GameEntity::GetMass(void) { return components->GetMass(component_row); }
 
-void Simplex::GameEntity::SetPosition(vector3 position) { if (physics) physics->SetPosition(position); }
-
-Simplex::vector3 Simplex::GameEntity::GetPosition(void)
+void Simplex::GameEntity::UsePhysics(bool use_physics)
 {
-	if (physics != nullptr) {
-		return physics->GetPosition();
+	if (use_physics) {
+		components->AddComponent(component_row, Component_Physics);
+		components->WakeUp(component_row);
+	}
+	else {
+		components->RemoveComponent(component_row, Component_Physics);
+		components->RemoveComponent(component_row, Component_Awake);
 	}
-	return vector3();
-}
-
-void Simplex::GameEntity::SetVelocity(vector3 velocity) { if (physics) physics->SetVelocity(velocity); }
-
-Simplex::vector3 Simplex::GameEntity::GetVelocity(void)
-{
-	if (physics != nullptr)
-		return physics->GetVelocity();
-	return vector3();
-}
-
-void Simplex::GameEntity::SetMass(float mass) { if (physics) physics->SetMass(mass); }
-
-float Simplex::GameEntity::GetMass(void)
-{
-	if (physics != nullptr)
-		return physics->GetMass();
-	return 1.0f;
 }
 
-Simplex::ObjectPhysics* Simplex::GameEntity::GetSolver(void) { return physics; }
-
-void Simplex::GameEntity::UsePhysics(bool use_physics)
-{
-	should_use_physics = use_physics;
-}
+int Simplex::GameEntity::GetMotionState(void) { return components->GetMotionState(component_row); }
+void Simplex::GameEntity::WakeUp(void) { components->WakeUp(component_row); }
 
 ObjectRigidBody* Simplex::GameEntity::GetRigidBody(void) { return rigid_body; }
 
 void Simplex::GameEntity::DisableRigidBody()
 {
-	is_rigid_body_disabled = true;
+	components->RemoveComponent(component_row, Component_Collider);
 }
 
 bool Simplex::GameEntity::HasThisRigidBody(ObjectRigidBody* rigid_body) { return rigid_body == rigid_body; }
 #pragma endregion
 
 #pragma region Render
-Model* Simplex::GameEntity::GetModel(void) { return model; }
+// The shared model, or null while it is still being loaded.
+Model* Simplex::GameEntity::GetModel(void) { return model_cache ? model_cache->GetModel(model_asset) : nullptr; }
 
-matrix4 Simplex::GameEntity::GetModelMatrix(void) { return world_matrix; }
+matrix4 Simplex::GameEntity::GetModelMatrix(void) { return components->GetWorldMatrix(component_row); }
 
 void Simplex::GameEntity::SetModelMatrix(matrix4 set_world_matrix)
 {
@@ -328,19 +299,26 @@ void Simplex::GameEntity::SetModelMatrix(matrix4 set_world_matrix)
 		return;
 	}
 
-	world_matrix = set_world_matrix;
-	model->SetModelMatrix(world_matrix);
-	rigid_body->SetModelMatrix(world_matrix);
+	components->SetWorldMatrix(component_row, set_world_matrix);
+}
 
-	glm::vec3 scale;
-	glm::quat rotation;
-	glm::vec3 translation;
-	glm::vec3 skew;
-	glm::vec4 perspective;
-	glm::decompose(world_matrix, scale, rotation, translation, skew, perspective);
+// Place the entity without going through a matrix, this is what anything that moves every frame should use. The
+// rigid body catches up in the manager's transform pass.
+void Simplex::GameEntity::SetTransform(vector3 position, quaternion rotation, vector3 scale)
+{
+	if (!entity_model_loaded_in_memory) {
+		return;
+	}
 
-	physics->SetPosition(translation);
-	physics->SetSize(scale);
+	components->SetTransform(component_row, position, rotation, scale);
+}
+
+// Hand the stored world matrix and box on to the rigid body after something moved the entity. The model is shared,
+// it only gets the matrix while this entity is being drawn.
+void Simplex::GameEntity::RefreshModelMatrix(void)
+{
+	rigid_body->SetModelMatrix(components->GetWorldMatrix(component_row), components->GetBoundsMin(component_row),
+		components->GetBoundsMax(component_row));
 }
 
 void Simplex::GameEntity::AddToRenderList(bool draw_rigid_body)
@@ -349,27 +327,49 @@ void Simplex::GameEntity::AddToRenderList(bool draw_rigid_body)
 		return;
 	}
 
-	if (!is_model_rendering_disabled) {
-		model->AddToRenderList();
+	Model* pModel = GetModel();
+	if (!is_model_rendering_disabled && pModel) {
+		pModel->SetModelMatrix(GetModelMatrix());
+		pModel->AddToRenderList();
 	}
 
-	if (draw_rigid_body && !is_rigid_body_disabled) {
-		rigid_body->AddToRenderList();
+	if (draw_rigid_body) {
+		AddRigidBodyToRenderList();
 	}
 
 	if (should_render_axis) {
-		mesh_manager->AddAxisToRenderList(world_matrix);
+		mesh_manager->AddAxisToRenderList(GetModelMatrix());
+	}
+}
+
+void Simplex::GameEntity::AddRigidBodyToRenderList(void)
+{
+	if (entity_model_loaded_in_memory && components->HasComponent(component_row, Component_Collider)) {
+		rigid_body->AddToRenderList();
 	}
 }
 
-void Simplex::GameEntity::SetAxisVisible(bool set_axis_enabled) { should_render_axis = set_axis_enabled; }
+void Simplex::GameEntity::SetAxisVisible(bool set_axis_enabled)
+{
+	should_render_axis = set_axis_enabled;
+	UpdateRenderComponent();
+}
 
 void Simplex::GameEntity::HideModelRender()
 {
 	is_model_rendering_disabled = true;
+	UpdateRenderComponent();
 }
 void Simplex::GameEntity::ShowModelRender()
 {
 	is_model_rendering_disabled = false;
+	UpdateRenderComponent();
+}
+
+// Only entities with something to draw take part in render submission.
+void Simplex::GameEntity::UpdateRenderComponent(void)
+{
+	if (!is_model_rendering_disabled || should_render_axis) components->AddComponent(component_row, Component_Render);
+	else components->RemoveComponent(component_row, Component_Render);
 }
 #pragma endregion
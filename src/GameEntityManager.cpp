@@ -1,13 +1,11 @@
 /*
-* Implementation of our game entity manager which wraps an array of entities loaded in memory. We wrap much
+* Implementation of our game entity manager which wraps a list of entities loaded in memory. We wrap much
 * of the functionality found in the GameEntity class.
 */
 #include "headers/GameEntityManager.h"
 
 using namespace Simplex;
 
-Simplex::GameEntityManager* Simplex::GameEntityManager::instance = nullptr;
-
 #pragma region Constructor / Destructor
 Simplex::GameEntityManager::GameEntityManager() { Init(); }
 Simplex::GameEntityManager::GameEntityManager(GameEntityManager const& other) { }
@@ -16,157 +14,267 @@ Simplex::GameEntityManager::~GameEntityManager() { Release(); };
 
 void Simplex::GameEntityManager::Release(void)
 {
-	for (uint uEntity = 0; uEntity < entity_count; ++uEntity)
+	for (uint uEntity = 0; uEntity < entities.size(); ++uEntity)
 	{
 		GameEntity* pEntity = entities[uEntity];
 		SafeDelete(pEntity);
 	}
-	entity_count = 0;
-	entities = nullptr;
+	entities.clear();
+	entity_slots.clear();
+	slot_entities.clear();
+	slot_generations.clear();
+	free_slots.clear();
+	named_handles.clear();
 }
 
 void Simplex::GameEntityManager::Init(void)
 {
-	entity_count = 0;
-	entities = nullptr;
+	entities.clear();
+	unique_id_suffix = 0;
 }
+#pragma endregion
 
-Simplex::GameEntityManager* Simplex::GameEntityManager::GetInstance()
+#pragma region Game State
+int Simplex::GameEntityManager::GetEntityIndex(String entity_id)
 {
-	if (instance == nullptr)
-	{
-		instance = new GameEntityManager();
-	}
-	return instance;
+	EntityHandle handle = GetHandle(entity_id);
+	return IsValid(handle) ? (int)slot_entities[handle.GetIndex()] : -1;
 }
-void Simplex::GameEntityManager::ReleaseInstance()
+
+int Simplex::GameEntityManager::GetEntityIndex(EntityHandle handle)
 {
-	if (instance != nullptr)
-	{
-		delete instance;
-		instance = nullptr;
-	}
+	return IsValid(handle) ? (int)slot_entities[handle.GetIndex()] : -1;
 }
-#pragma endregion
 
-#pragma region Game State
-int Simplex::GameEntityManager::GetEntityIndex(String entity_id)
+// Make room for this many entities up front so building a big board never has to grow the list.
+void Simplex::GameEntityManager::Reserve(uint entity_capacity)
 {
-	for (uint uIndex = 0; uIndex < entity_count; ++uIndex) {
-		if (entity_id == entities[uIndex]->GetUniqueID()) {
-			return uIndex;
-		}
+	entities.reserve(entity_capacity);
+	entity_slots.reserve(entity_capacity);
+	slot_entities.reserve(entity_capacity);
+	slot_generations.reserve(entity_capacity);
+	components.Reserve(entity_capacity);
+}
+
+// Start reading these model files on worker threads so they are ready by the time entities ask for them.
+void Simplex::GameEntityManager::PrefetchModels(std::vector<String> const& model_file_names)
+{
+	model_cache.Prefetch(model_file_names);
+}
+
+// Send finished models to the GPU, this must be called from the render thread. Returns how many are still loading.
+Simplex::uint Simplex::GameEntityManager::UploadModels(uint upload_budget)
+{
+	return model_cache.Upload(upload_budget);
+}
+
+Simplex::EntityHandle Simplex::GameEntityManager::AddEntity(String model_file_name, String entity_id)
+{
+	// Every entity made from the same file shares one model. We only wait for its bounds here, the model itself can
+	// still be on its way to the GPU.
+	int asset = model_cache.Acquire(model_file_name);
+	if (asset == -1) {
+		return EntityHandle();
 	}
 
-	return -1;
+	GenUniqueID(entity_id);
+
+	// Reuse a slot given up by a removed entity, its generation was bumped on the way out. The slot doubles as the
+	// entity's row in the component store.
+	uint slot = free_slots.empty() ? slot_generations.size() : free_slots.back();
+	GameEntity* pTemp = new GameEntity(&model_cache, asset, entity_id, &components, slot);
+
+	if (!free_slots.empty()) {
+		free_slots.pop_back();
+	}
+	else {
+		slot_generations.push_back(1);
+		slot_entities.push_back(0);
+	}
+
+	slot_entities[slot] = entities.size();
+	entity_slots.push_back(slot);
+	entities.push_back(pTemp);
+
+	EntityHandle handle = EntityHandle::Make(slot, slot_generations[slot]);
+	uint symbol = entity_names.Intern(entity_id);
+	if (symbol >= named_handles.size()) named_handles.resize(symbol + 1);
+	named_handles[symbol] = handle;
+	return handle;
 }
 
-void Simplex::GameEntityManager::AddEntity(String model_file_name, String entity_id)
+// Add one entity per id, all using the same model. Entities that failed to load come back as null handles.
+void Simplex::GameEntityManager::AddEntities(String model_file_name, std::vector<String> const& entity_ids, std::vector<EntityHandle>& added_handles)
 {
-	GameEntity* pTemp = new GameEntity(model_file_name, entity_id);
-	
-	if (pTemp->IsInitialized()) {
-		GameEntity** tempArray = new GameEntity*[entity_count + 1];
-		
-		uint uCount = 0;
-		for (uint i = 0; i < entity_count; ++i) {
-			tempArray[uCount] = entities[i];
-			++uCount;
-		}
-		tempArray[uCount] = pTemp;
-		
-		if (entities) {
-			delete[] entities;
-		}
-		
-		entities = tempArray;
-		++entity_count;
+	Reserve(entities.size() + entity_ids.size());
+	added_handles.clear();
+	added_handles.reserve(entity_ids.size());
+	for (uint i = 0; i < entity_ids.size(); i++) {
+		added_handles.push_back(AddEntity(model_file_name, entity_ids[i]));
 	}
 }
 
+// Swap the last entity into the gap. Only the index of the moved entity changes, its handle stays the same.
 void Simplex::GameEntityManager::RemoveEntity(uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
-	if (entity_index != entity_count - 1) {
-		std::swap(entities[entity_index], entities[entity_count - 1]);
+	GameEntity* pEntity = entities[entity_index];
+	int symbol = entity_names.Find(pEntity->GetUniqueID());
+	if (symbol != -1) named_handles[symbol] = EntityHandle();
+
+	// Generations run from 1 so the null handle can never come back to life.
+	uint slot = entity_slots[entity_index];
+	slot_generations[slot] = slot_generations[slot] % EntityHandle::GENERATION_MASK + 1;
+	slot_entities[slot] = (uint)-1;
+	free_slots.push_back(slot);
+
+	uint lastIndex = entities.size() - 1;
+	if (entity_index != lastIndex) {
+		entities[entity_index] = entities[lastIndex];
+		entity_slots[entity_index] = entity_slots[lastIndex];
+		slot_entities[entity_slots[entity_index]] = entity_index;
 	}
+	entities.pop_back();
+	entity_slots.pop_back();
+	SafeDelete(pEntity);
+}
 
-	GameEntity** tempArray = new GameEntity*[entity_count - 1];
-	
-	for (uint i = 0; i < entity_count - 1; ++i) {
-		tempArray[i] = entities[i];
+void Simplex::GameEntityManager::RemoveEntity(String entity_id)
+{
+	RemoveEntity(GetHandle(entity_id));
+}
+
+void Simplex::GameEntityManager::RemoveEntity(EntityHandle handle)
+{
+	int nIndex = GetEntityIndex(handle);
+	if (nIndex == -1) {
+		return;
 	}
-	
-	if (entities) {
-		delete[] entities;
+	RemoveEntity((uint)nIndex);
+}
+
+// A handle is good while its slot holds an entity of the same generation.
+bool Simplex::GameEntityManager::IsValid(EntityHandle handle)
+{
+	uint slot = handle.GetIndex();
+	return !handle.IsNull() && slot < slot_generations.size() && slot_entities[slot] != (uint)-1 &&
+		slot_generations[slot] == handle.GetGeneration();
+}
+
+Simplex::EntityHandle Simplex::GameEntityManager::GetHandle(uint entity_index)
+{
+	if (entity_index >= entities.size()) {
+		return EntityHandle();
 	}
 
-	entities = tempArray;
-	--entity_count;
+	uint slot = entity_slots[entity_index];
+	return EntityHandle::Make(slot, slot_generations[slot]);
 }
 
-void Simplex::GameEntityManager::RemoveEntity(String entity_id)
+// Look an entity up by name. This is meant for debugging and tools, the game itself holds on to handles.
+Simplex::EntityHandle Simplex::GameEntityManager::GetHandle(String entity_id)
 {
-	int nIndex = GetEntityIndex(entity_id);
-	RemoveEntity((uint)nIndex);
+	int symbol = entity_names.Find(entity_id);
+	return symbol == -1 ? EntityHandle() : named_handles[symbol];
 }
 
 Simplex::String Simplex::GameEntityManager::GetUniqueID(uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return "";
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->GetUniqueID();
 }
 
-Simplex::uint Simplex::GameEntityManager::GetEntityCount(void) { return entity_count; }
+Simplex::uint Simplex::GameEntityManager::GetEntityCount(void) { return entities.size(); }
 
 Simplex::GameEntity* Simplex::GameEntityManager::GetEntity(uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return nullptr;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index];
 }
 
+Simplex::GameEntity* Simplex::GameEntityManager::GetEntity(String entity_id)
+{
+	//look the entity based on the unique id
+	int nIndex = GetEntityIndex(entity_id);
+	//if not found return nullptr, if found return it
+	return nIndex == -1 ? nullptr : entities[nIndex];
+}
+
+Simplex::GameEntity* Simplex::GameEntityManager::GetEntity(EntityHandle handle)
+{
+	return IsValid(handle) ? entities[slot_entities[handle.GetIndex()]] : nullptr;
+}
+
+// Ids only have to be unique within this manager, a clash gets a number added to the end.
+void Simplex::GameEntityManager::GenUniqueID(String& entity_id)
+{
+	String sName = entity_id;
+	GameEntity* pEntity = GetEntity(entity_id);
+
+	while (pEntity) {
+		entity_id = sName + "_" + std::to_string(unique_id_suffix);
+		unique_id_suffix++;
+		pEntity = GetEntity(entity_id);
+	}
+}
+
 void Simplex::GameEntityManager::Update(void)
 {
-	for (uint i = 0; i < entity_count; i++) {
-		entities[i]->ClearCollisionList();
+	// Only awake bodies cost anything per frame. Static entities and sleeping bodies are skipped until something
+	// moves or pushes them.
+	std::vector<uint> const& awakeRows = components.GetMembers(Component_Awake);
+	for (uint i = 0; i < awakeRows.size(); i++) {
+		entities[slot_entities[awakeRows[i]]]->ClearCollisionList();
 	}
 
-	for (uint i = 0; i < entity_count; i++) {
-		entities[i]->Update();
+	// Physics runs straight over the component arrays. Bodies that moved are picked up by the transform pass.
+	components.IntegratePhysics();
+}
+
+// Once a frame before drawing: rebuild the matrices of everything that moved since the last pass and hand them to
+// the rigid bodies. Entities that didn't move aren't visited at all.
+void Simplex::GameEntityManager::UpdateTransforms(void)
+{
+	components.UpdateTransforms();
+	std::vector<uint> const& movedRows = components.GetMovedRows();
+	for (uint i = 0; i < movedRows.size(); i++) {
+		uint entityIndex = slot_entities[movedRows[i]];
+		if (entityIndex != (uint)-1) entities[entityIndex]->RefreshModelMatrix();
 	}
+	components.ClearMovedRows();
 }
 #pragma endregion
 
 #pragma region Collision
 void Simplex::GameEntityManager::AddDimension(uint entity_index, uint dimension)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->AddDimension(dimension);
@@ -174,7 +282,7 @@ void Simplex::GameEntityManager::AddDimension(uint entity_index, uint dimension)
 
 void Simplex::GameEntityManager::AddDimension(String entity_id, uint dimension)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 	if (pTemp) {
 		pTemp->AddDimension(dimension);
 	}
@@ -182,12 +290,12 @@ void Simplex::GameEntityManager::AddDimension(String entity_id, uint dimension)
 
 void Simplex::GameEntityManager::RemoveDimension(uint entity_index, uint dimension)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->RemoveDimension(dimension);
@@ -195,7 +303,7 @@ void Simplex::GameEntityManager::RemoveDimension(uint entity_index, uint dimensi
 
 void Simplex::GameEntityManager::RemoveDimension(String entity_id, uint dimension)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 	if (pTemp) {
 		pTemp->RemoveDimension(dimension);
 	}
@@ -203,19 +311,19 @@ void Simplex::GameEntityManager::RemoveDimension(String entity_id, uint dimensio
 
 void Simplex::GameEntityManager::ClearDimensionSetAll(void)
 {
-	for (uint i = 0; i < entity_count; ++i) {
+	for (uint i = 0; i < entities.size(); ++i) {
 		ClearDimensionSet(i);
 	}
 }
 
 void Simplex::GameEntityManager::ClearDimensionSet(uint entity_index)
 {	
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->ClearDimensionSet();
@@ -223,7 +331,7 @@ void Simplex::GameEntityManager::ClearDimensionSet(uint entity_index)
 
 void Simplex::GameEntityManager::ClearDimensionSet(String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		pTemp->ClearDimensionSet();
@@ -232,12 +340,12 @@ void Simplex::GameEntityManager::ClearDimensionSet(String entity_id)
 
 bool Simplex::GameEntityManager::IsInDimension(uint entity_index, uint dimension)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return false;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->IsInDimension(dimension);
@@ -245,7 +353,7 @@ bool Simplex::GameEntityManager::IsInDimension(uint entity_index, uint dimension
 
 bool Simplex::GameEntityManager::IsInDimension(String entity_id, uint dimension)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		return pTemp->IsInDimension(dimension);
@@ -255,12 +363,12 @@ bool Simplex::GameEntityManager::IsInDimension(String entity_id, uint dimension)
 
 bool Simplex::GameEntityManager::SharesDimension(uint entity_index, GameEntity* const other_entity)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return false;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->SharesDimension(other_entity);
@@ -268,7 +376,7 @@ bool Simplex::GameEntityManager::SharesDimension(uint entity_index, GameEntity*
 
 bool Simplex::GameEntityManager::SharesDimension(String entity_id, GameEntity* const other_entity)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		return pTemp->SharesDimension(other_entity);
@@ -278,7 +386,7 @@ bool Simplex::GameEntityManager::SharesDimension(String entity_id, GameEntity* c
 
 void Simplex::GameEntityManager::DisableRigidBody(String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 	if (pTemp) {
 		pTemp->DisableRigidBody();
 	}
@@ -287,12 +395,12 @@ void Simplex::GameEntityManager::DisableRigidBody(String entity_id)
 
 Simplex::ObjectRigidBody* Simplex::GameEntityManager::GetRigidBody(uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return nullptr;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->GetRigidBody();
@@ -300,7 +408,7 @@ Simplex::ObjectRigidBody* Simplex::GameEntityManager::GetRigidBody(uint entity_i
 
 Simplex::ObjectRigidBody* Simplex::GameEntityManager::GetRigidBody(String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		return pTemp->GetRigidBody();
@@ -312,7 +420,7 @@ Simplex::ObjectRigidBody* Simplex::GameEntityManager::GetRigidBody(String entity
 #pragma region Physics
 void Simplex::GameEntityManager::ApplyForce(vector3 force, String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		pTemp->ApplyForce(force);
@@ -320,14 +428,23 @@ void Simplex::GameEntityManager::ApplyForce(vector3 force, String entity_id)
 	return;
 }
 
+void Simplex::GameEntityManager::ApplyForce(vector3 force, EntityHandle handle)
+{
+	GameEntity* pTemp = GetEntity(handle);
+
+	if (pTemp) {
+		pTemp->ApplyForce(force);
+	}
+}
+
 void Simplex::GameEntityManager::ApplyForce(vector3 force, uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->ApplyForce(force);
@@ -335,7 +452,7 @@ void Simplex::GameEntityManager::ApplyForce(vector3 force, uint entity_index)
 
 void Simplex::GameEntityManager::SetPosition(vector3 position, String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		pTemp->SetPosition(position);
@@ -345,12 +462,12 @@ void Simplex::GameEntityManager::SetPosition(vector3 position, String entity_id)
 
 void Simplex::GameEntityManager::SetPosition(vector3 position, uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	entities[entity_index]->SetPosition(position);
@@ -360,7 +477,7 @@ void Simplex::GameEntityManager::SetPosition(vector3 position, uint entity_index
 
 void Simplex::GameEntityManager::SetMass(float mass, String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		pTemp->SetMass(mass);
@@ -370,12 +487,12 @@ void Simplex::GameEntityManager::SetMass(float mass, String entity_id)
 
 void Simplex::GameEntityManager::SetMass(float mass, uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	entities[entity_index]->SetMass(mass);
@@ -385,7 +502,7 @@ void Simplex::GameEntityManager::SetMass(float mass, uint entity_index)
 
 void Simplex::GameEntityManager::UsePhysics(bool use_physics, String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		pTemp->UsePhysics(use_physics);
@@ -395,12 +512,12 @@ void Simplex::GameEntityManager::UsePhysics(bool use_physics, String entity_id)
 
 void Simplex::GameEntityManager::UsePhysics(bool use_physics, uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->UsePhysics(use_physics);
@@ -410,19 +527,19 @@ void Simplex::GameEntityManager::UsePhysics(bool use_physics, uint entity_index)
 #pragma region Rendering
 Simplex::Model* Simplex::GameEntityManager::GetModel(uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return nullptr;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->GetModel();
 }
 Simplex::Model* Simplex::GameEntityManager::GetModel(String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 	
 	if (pTemp) {
 		return pTemp->GetModel();
@@ -432,19 +549,19 @@ Simplex::Model* Simplex::GameEntityManager::GetModel(String entity_id)
 
 Simplex::matrix4 Simplex::GameEntityManager::GetModelMatrix(uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return matrix4();
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->GetModelMatrix();
 }
 Simplex::matrix4 Simplex::GameEntityManager::GetModelMatrix(String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		return pTemp->GetModelMatrix();
@@ -454,12 +571,12 @@ Simplex::matrix4 Simplex::GameEntityManager::GetModelMatrix(String entity_id)
 
 void Simplex::GameEntityManager::SetModelMatrix(matrix4 world_matrix, uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	entities[entity_index]->SetModelMatrix(world_matrix);
@@ -467,17 +584,35 @@ void Simplex::GameEntityManager::SetModelMatrix(matrix4 world_matrix, uint entit
 
 void Simplex::GameEntityManager::SetModelMatrix(matrix4 world_matrix, String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		pTemp->SetModelMatrix(world_matrix);
 	}
 }
 
+void Simplex::GameEntityManager::SetModelMatrix(matrix4 world_matrix, EntityHandle handle)
+{
+	GameEntity* pTemp = GetEntity(handle);
+
+	if (pTemp) {
+		pTemp->SetModelMatrix(world_matrix);
+	}
+}
+
+void Simplex::GameEntityManager::SetTransform(vector3 position, quaternion rotation, EntityHandle handle)
+{
+	GameEntity* pTemp = GetEntity(handle);
+
+	if (pTemp) {
+		pTemp->SetTransform(position, rotation);
+	}
+}
+
 
 void Simplex::GameEntityManager::HideModelRender(String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		pTemp->HideModelRender();
@@ -486,21 +621,37 @@ void Simplex::GameEntityManager::HideModelRender(String entity_id)
 
 void Simplex::GameEntityManager::ShowModelRender(String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 	if (pTemp) {
 		pTemp->ShowModelRender();
 	}
 
 }
 
+void Simplex::GameEntityManager::HideModelRender(EntityHandle handle)
+{
+	GameEntity* pTemp = GetEntity(handle);
+	if (pTemp) {
+		pTemp->HideModelRender();
+	}
+}
+
+void Simplex::GameEntityManager::ShowModelRender(EntityHandle handle)
+{
+	GameEntity* pTemp = GetEntity(handle);
+	if (pTemp) {
+		pTemp->ShowModelRender();
+	}
+}
+
 void Simplex::GameEntityManager::SetAxisVisibility(bool axis_visibility, uint entity_index)
 {
-	if (entity_count == 0) {
+	if (entities.size() == 0) {
 		return;
 	}
 
-	if (entity_index >= entity_count) {
-		entity_index = entity_count - 1;
+	if (entity_index >= entities.size()) {
+		entity_index = entities.size() - 1;
 	}
 
 	return entities[entity_index]->SetAxisVisible(axis_visibility);
@@ -508,7 +659,7 @@ void Simplex::GameEntityManager::SetAxisVisibility(bool axis_visibility, uint en
 
 void Simplex::GameEntityManager::SetAxisVisibility(bool axis_visibility, String entity_id)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	GameEntity* pTemp = GetEntity(entity_id);
 	
 	if (pTemp) {
 		pTemp->SetAxisVisible(axis_visibility);
@@ -517,9 +668,19 @@ void Simplex::GameEntityManager::SetAxisVisibility(bool axis_visibility, String
 
 void Simplex::GameEntityManager::AddEntityToRenderList(uint entity_index, bool rigid_body)
 {
-	if (entity_index >= entity_count) {
-		for (entity_index = 0; entity_index < entity_count; ++entity_index) {
-			entities[entity_index]->AddToRenderList(rigid_body);
+	UpdateTransforms();
+
+	if (entity_index >= entities.size()) {
+		std::vector<uint> const& renderRows = components.GetMembers(Component_Render);
+		for (uint i = 0; i < renderRows.size(); ++i) {
+			entities[slot_entities[renderRows[i]]]->AddToRenderList(false);
+		}
+
+		if (rigid_body) {
+			std::vector<uint> const& colliderRows = components.GetMembers(Component_Collider);
+			for (uint i = 0; i < colliderRows.size(); ++i) {
+				entities[slot_entities[colliderRows[i]]]->AddRigidBodyToRenderList();
+			}
 		}
 	} else {
 		entities[entity_index]->AddToRenderList(rigid_body);
@@ -528,7 +689,8 @@ void Simplex::GameEntityManager::AddEntityToRenderList(uint entity_index, bool r
 
 void Simplex::GameEntityManager::AddEntityToRenderList(String entity_id, bool rigid_body)
 {
-	GameEntity* pTemp = GameEntity::GetEntity(entity_id);
+	UpdateTransforms();
+	GameEntity* pTemp = GetEntity(entity_id);
 
 	if (pTemp) {
 		pTemp->AddToRenderList(rigid_body);
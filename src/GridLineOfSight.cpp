@@ -0,0 +1,208 @@
+/*
+* Implementation of the grid line of sight queries. Each row of the board is packed into 64 bit words so lines that
+* stay in one row are checked a word at a time, everything else steps through the tiles with a DDA walk.
+*/
+#include "headers/GridLineOfSight.h"
+#include <cfloat>
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void GridLineOfSight::Release(void) { walkable_bits.clear(); }
+
+void GridLineOfSight::Init(void)
+{
+	grid_width = 0;
+	grid_height = 0;
+	words_per_row = 0;
+	walkable_bits.clear();
+}
+
+GridLineOfSight::GridLineOfSight(int width, int height)
+{
+	Init();
+	grid_width = width;
+	grid_height = height;
+	words_per_row = (width + 63) / 64;
+	walkable_bits.assign(words_per_row * height, 0);
+
+	for (int z = 0; z < height; z++) {
+		for (int x = 0; x < width; x++) {
+			SetWalkable(x, z, true);
+		}
+	}
+}
+
+GridLineOfSight::GridLineOfSight(GridLineOfSight const& other)
+{
+	grid_width = other.grid_width;
+	grid_height = other.grid_height;
+	words_per_row = other.words_per_row;
+	walkable_bits = other.walkable_bits;
+}
+
+GridLineOfSight& GridLineOfSight::operator=(GridLineOfSight const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		GridLineOfSight temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+GridLineOfSight::~GridLineOfSight() { Release(); }
+
+void GridLineOfSight::Swap(GridLineOfSight& other)
+{
+	std::swap(grid_width, other.grid_width);
+	std::swap(grid_height, other.grid_height);
+	std::swap(words_per_row, other.words_per_row);
+	std::swap(walkable_bits, other.walkable_bits);
+}
+#pragma endregion
+
+#pragma region Bitmap
+void GridLineOfSight::SetWalkable(int x, int z, bool is_walkable)
+{
+	if (x < 0 || z < 0 || x >= grid_width || z >= grid_height) {
+		return;
+	}
+
+	uint64_t& word = walkable_bits[z * words_per_row + (x >> 6)];
+	uint64_t bit = 1ull << (x & 63);
+	if (is_walkable) word |= bit;
+	else word &= ~bit;
+}
+
+bool GridLineOfSight::GetWalkable(int x, int z)
+{
+	if (x < 0 || z < 0 || x >= grid_width || z >= grid_height) {
+		return false;
+	}
+
+	return (walkable_bits[z * words_per_row + (x >> 6)] >> (x & 63)) & 1ull;
+}
+
+// Check a run of tiles in one row a whole word at a time.
+bool GridLineOfSight::RowClear(int z, int min_x, int max_x)
+{
+	if (z < 0 || z >= grid_height || min_x < 0 || max_x >= grid_width) {
+		return false;
+	}
+
+	const uint64_t* row = &walkable_bits[z * words_per_row];
+	int firstWord = min_x >> 6;
+	int lastWord = max_x >> 6;
+
+	for (int word = firstWord; word <= lastWord; word++) {
+		uint64_t mask = ~0ull;
+		if (word == firstWord) mask &= ~0ull << (min_x & 63);
+		if (word == lastWord) mask &= ~0ull >> (63 - (max_x & 63));
+		if ((row[word] & mask) != mask) return false;
+	}
+
+	return true;
+}
+#pragma endregion
+
+#pragma region Queries
+bool GridLineOfSight::HasLineOfSight(vector2 from, vector2 to)
+{
+	int z = (int)glm::floor(from.y);
+	if (z == (int)glm::floor(to.y)) {
+		int fromX = (int)glm::floor(from.x);
+		int toX = (int)glm::floor(to.x);
+		return RowClear(z, glm::min(fromX, toX), glm::max(fromX, toX));
+	}
+
+	return TraverseLine(from, to);
+}
+
+// Test many lines at once. The first pass is plain arithmetic over the arrays and sorts out the lines that stay in a
+// single row, only the rest need the tile by tile walk.
+void GridLineOfSight::HasLineOfSight(std::vector<vector2> const& from, std::vector<vector2> const& to, std::vector<char>& visible)
+{
+	uint count = glm::min(from.size(), to.size());
+	visible.assign(count, 0);
+
+	std::vector<int> fromRow(count);
+	std::vector<int> toRow(count);
+	for (uint i = 0; i < count; i++) {
+		fromRow[i] = (int)glm::floor(from[i].y);
+		toRow[i] = (int)glm::floor(to[i].y);
+	}
+
+	for (uint i = 0; i < count; i++) {
+		if (fromRow[i] != toRow[i]) continue;
+
+		int fromX = (int)glm::floor(from[i].x);
+		int toX = (int)glm::floor(to[i].x);
+		visible[i] = RowClear(fromRow[i], glm::min(fromX, toX), glm::max(fromX, toX));
+	}
+
+	for (uint i = 0; i < count; i++) {
+		if (fromRow[i] == toRow[i]) continue;
+		visible[i] = TraverseLine(from[i], to[i]);
+	}
+}
+
+// Amanatides and Woo grid walk. Step into whichever tile border the line reaches first, until the borders are past
+// the end of the segment. A border reached right at the end only counts when it leads into the end tile, so a line
+// ending on a tile corner never walks on into the tiles beyond it.
+bool GridLineOfSight::TraverseLine(vector2 from, vector2 to)
+{
+	int x = (int)glm::floor(from.x);
+	int z = (int)glm::floor(from.y);
+	int endX = (int)glm::floor(to.x);
+	int endZ = (int)glm::floor(to.y);
+
+	if (!GetWalkable(x, z) || !GetWalkable(endX, endZ)) {
+		return false;
+	}
+
+	vector2 delta = to - from;
+	int stepX = delta.x > 0.0f ? 1 : (delta.x < 0.0f ? -1 : 0);
+	int stepZ = delta.y > 0.0f ? 1 : (delta.y < 0.0f ? -1 : 0);
+
+	float tDeltaX = stepX != 0 ? 1.0f / glm::abs(delta.x) : FLT_MAX;
+	float tDeltaZ = stepZ != 0 ? 1.0f / glm::abs(delta.y) : FLT_MAX;
+	float tMaxX = stepX > 0 ? (x + 1 - from.x) * tDeltaX : (stepX < 0 ? (from.x - x) * tDeltaX : FLT_MAX);
+	float tMaxZ = stepZ > 0 ? (z + 1 - from.y) * tDeltaZ : (stepZ < 0 ? (from.y - z) * tDeltaZ : FLT_MAX);
+
+	// One step per tile border, plus one for each axis that may be retired at the very end.
+	const float epsilon = 0.00001f;
+	int maxSteps = glm::abs(endX - x) + glm::abs(endZ - z) + 2;
+	for (int i = 0; i < maxSteps && (x != endX || z != endZ); i++) {
+		if (glm::min(tMaxX, tMaxZ) > 1.0f + epsilon) break;
+
+		// Never step an axis that is already at the end tile.
+		bool crossX = tMaxX <= tMaxZ + epsilon && x != endX;
+		bool crossZ = tMaxZ <= tMaxX + epsilon && z != endZ;
+		if (!crossX && !crossZ) {
+			if (tMaxX <= tMaxZ) tMaxX = FLT_MAX;
+			else tMaxZ = FLT_MAX;
+			continue;
+		}
+
+		if (crossX && crossZ) {
+			// Right through a corner. Both tiles beside the corner have to be clear as well.
+			if (!GetWalkable(x + stepX, z) || !GetWalkable(x, z + stepZ)) return false;
+		}
+		if (crossX) {
+			x += stepX;
+			tMaxX += tDeltaX;
+		}
+		if (crossZ) {
+			z += stepZ;
+			tMaxZ += tDeltaZ;
+		}
+
+		if (!GetWalkable(x, z)) return false;
+	}
+
+	return true;
+}
+#pragma endregion
@@ -0,0 +1,274 @@
+/*
+* Implementation of the shared model cache.
+*/
+#include "headers/ModelCache.h"
+#include "headers/ObjectRigidBody.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace Simplex;
+
+// What we write next to a cooked model. Fixed size, so reading it back is a single read.
+struct CookedBounds
+{
+	uint magic;
+	uint version;
+	unsigned long long content_hash;
+	float local_min[4];
+	float local_max[4];
+};
+const uint COOKED_BOUNDS_MAGIC = 0x444E4242; // "BBND"
+const uint COOKED_BOUNDS_VERSION = 1;
+
+// FNV-1a over the whole file, only used to tell one version of a model file from another.
+unsigned long long HashContents(String const& contents)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	for (uint i = 0; i < contents.size(); i++) {
+		hash ^= (unsigned char)contents[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Bounds of the vertex positions in an OBJ file, taken from its cooked bounds file when there is one for this exact
+// version of the file. This runs on a worker thread so it only touches files.
+ModelBounds ReadObjBounds(String file_name, String file_path, String cooked_folder)
+{
+	ModelBounds bounds;
+	std::ifstream file(file_path, std::ios::binary);
+	if (!file) return bounds;
+	std::ostringstream buffer;
+	buffer << file.rdbuf();
+	String contents = buffer.str();
+
+	bounds.content_hash = HashContents(contents);
+	std::ostringstream cookedName;
+	cookedName << file_name.substr(0, file_name.size() - 4) << "_" << std::hex << std::setw(16) << std::setfill('0') << bounds.content_hash << ".bto";
+	bounds.cooked_name = cookedName.str();
+
+	CookedBounds cooked;
+	std::ifstream cookedFile(cooked_folder + bounds.cooked_name + ".bounds", std::ios::binary);
+	if (cookedFile.read((char*)&cooked, sizeof(cooked)) && cooked.magic == COOKED_BOUNDS_MAGIC &&
+		cooked.version == COOKED_BOUNDS_VERSION && cooked.content_hash == bounds.content_hash) {
+		bounds.local_min = vector3(cooked.local_min[0], cooked.local_min[1], cooked.local_min[2]);
+		bounds.local_max = vector3(cooked.local_max[0], cooked.local_max[1], cooked.local_max[2]);
+		bounds.read = true;
+		bounds.cooked = true;
+		return bounds;
+	}
+
+	std::istringstream lines(contents);
+	String line;
+	while (std::getline(lines, line)) {
+		if (line.size() < 2 || line[0] != 'v' || line[1] != ' ') continue;
+
+		vector3 position;
+		std::istringstream values(line.substr(2));
+		if (!(values >> position.x >> position.y >> position.z)) continue;
+
+		if (!bounds.read) bounds.local_min = bounds.local_max = position;
+		bounds.local_min = glm::min(bounds.local_min, position);
+		bounds.local_max = glm::max(bounds.local_max, position);
+		bounds.read = true;
+	}
+	return bounds;
+}
+
+#pragma region Constructors / Destructors
+void ModelCache::Release(void)
+{
+	// The mesh manager will release the models themselves.
+	assets.clear();
+	asset_lookup.clear();
+	upload_queue.clear();
+}
+
+void ModelCache::Init(void) { }
+
+ModelCache::ModelCache(void) { Init(); }
+
+ModelCache::ModelCache(ModelCache const& other)
+{
+	assets = other.assets;
+	asset_lookup = other.asset_lookup;
+	upload_queue = other.upload_queue;
+}
+
+ModelCache& ModelCache::operator=(ModelCache const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		ModelCache temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+ModelCache::~ModelCache() { Release(); }
+
+void ModelCache::Swap(ModelCache& other)
+{
+	std::swap(assets, other.assets);
+	std::swap(asset_lookup, other.asset_lookup);
+	std::swap(upload_queue, other.upload_queue);
+}
+#pragma endregion
+
+#pragma region Assets
+// Asset for a file, starting to read it on a worker thread the first time it is asked for. Only OBJ files can be read
+// ahead, anything else is loaded whole on the render thread when an entity needs it.
+uint ModelCache::Request(String file_name)
+{
+	auto lookup = asset_lookup.find(file_name);
+	if (lookup != asset_lookup.end()) return lookup->second;
+
+	ModelAsset asset;
+	asset.file_name = file_name;
+	if (file_name.size() > 4 && file_name.compare(file_name.size() - 4, 4, ".obj") == 0) {
+		Folder* folder = Folder::GetInstance();
+		String dataFolder = folder->GetFolderRoot() + folder->GetFolderData();
+		asset.bounds_task = std::async(std::launch::async, ReadObjBounds, file_name, dataFolder + folder->GetFolderMOBJ() + file_name,
+			dataFolder + folder->GetFolderMBTO()).share();
+	}
+
+	assets.push_back(asset);
+	asset_lookup[file_name] = assets.size() - 1;
+	return assets.size() - 1;
+}
+
+// Start reading all of these files at once so they are parsed side by side.
+void ModelCache::Prefetch(std::vector<String> const& file_names)
+{
+	for (uint i = 0; i < file_names.size(); i++) Request(file_names[i]);
+}
+
+// Asset for a file once its bounds are known, waiting for the worker if it is still reading. Returns -1 if the file
+// can't be loaded, a failed file is remembered so it isn't tried again for every entity that asks. The model itself
+// may still be on its way to the GPU.
+int ModelCache::Acquire(String file_name)
+{
+	uint asset = Request(file_name);
+	if (assets[asset].state == ModelAssetState_Reading) FinishReading(asset);
+	return assets[asset].state == ModelAssetState_Failed ? -1 : (int)asset;
+}
+
+// Take the bounds from the worker and queue the model for upload. When the worker couldn't read the file, load the
+// model right away and measure it, the model loader knows more places to look for a file than we do.
+void ModelCache::FinishReading(uint asset)
+{
+	ModelAsset& pending = assets[asset];
+	ModelBounds bounds;
+	if (pending.bounds_task.valid()) bounds = pending.bounds_task.get();
+	pending.bounds_task = std::shared_future<ModelBounds>();
+
+	pending.cooked_name = bounds.cooked_name;
+	pending.content_hash = bounds.content_hash;
+	pending.cooked = bounds.cooked;
+	if (bounds.read) {
+		pending.local_min = bounds.local_min;
+		pending.local_max = bounds.local_max;
+		pending.state = ModelAssetState_Uploading;
+		upload_queue.push_back(asset);
+		return;
+	}
+
+	LoadModel(asset);
+}
+
+// Load the model and send it to the GPU. This has to run on the thread that owns the GL context. A cooked model is
+// loaded from its BTO file, if that is missing or broken we go back to the source file and cook it again.
+bool ModelCache::LoadModel(uint asset)
+{
+	ModelAsset& pending = assets[asset];
+	if (pending.cooked) {
+		pending.model = new Model();
+		pending.model->LoadBTO(pending.cooked_name);
+		if (pending.model->GetName() != "") {
+			pending.state = ModelAssetState_Ready;
+			return true;
+		}
+		SafeDelete(pending.model);
+		pending.cooked = false;
+	}
+
+	pending.model = new Model();
+	pending.model->Load(pending.file_name);
+	if (pending.model->GetName() == "") {
+		SafeDelete(pending.model);
+		pending.state = ModelAssetState_Failed;
+		return false;
+	}
+
+	// Still reading means the worker never measured this model. The bounds have to be in place before they are cooked.
+	if (pending.state == ModelAssetState_Reading) {
+		ObjectRigidBody::ComputeLocalBounds(pending.model->GetVertexList(), pending.local_min, pending.local_max);
+	}
+
+	pending.state = ModelAssetState_Ready;
+	CookModel(asset);
+	return true;
+}
+
+// Save a freshly loaded model as BTO together with its bounds, so the next run can skip the source file. The bounds
+// file goes last, a cook only counts once it is there.
+void ModelCache::CookModel(uint asset)
+{
+	ModelAsset& loaded = assets[asset];
+	if (loaded.cooked_name == "") return;
+
+	BTO_OUTPUT saved = loaded.model->SaveBTO(loaded.cooked_name);
+	if (saved != OUT_ERR_NONE && saved != OUT_DONE) return;
+
+	CookedBounds cooked;
+	cooked.magic = COOKED_BOUNDS_MAGIC;
+	cooked.version = COOKED_BOUNDS_VERSION;
+	cooked.content_hash = loaded.content_hash;
+	for (uint i = 0; i < 3; i++) {
+		cooked.local_min[i] = loaded.local_min[i];
+		cooked.local_max[i] = loaded.local_max[i];
+	}
+	cooked.local_min[3] = cooked.local_max[3] = 0.0f;
+
+	Folder* folder = Folder::GetInstance();
+	String cookedPath = folder->GetFolderRoot() + folder->GetFolderData() + folder->GetFolderMBTO() + loaded.cooked_name;
+	std::ofstream cookedFile(cookedPath + ".bounds", std::ios::binary | std::ios::trunc);
+	cookedFile.write((const char*)&cooked, sizeof(cooked));
+	loaded.cooked = (bool)cookedFile;
+}
+
+// Called once a frame on the render thread. Picks up files the workers have finished and uploads at most this many
+// models so a long queue never stalls a frame. Returns how many files are still on their way.
+uint ModelCache::Upload(uint upload_budget)
+{
+	for (uint i = 0; i < assets.size(); i++) {
+		if (assets[i].state != ModelAssetState_Reading || !assets[i].bounds_task.valid()) continue;
+		if (assets[i].bounds_task.wait_for(std::chrono::seconds(0)) == std::future_status::ready) FinishReading(i);
+	}
+
+	uint uploaded = 0;
+	while (uploaded < upload_budget && !upload_queue.empty()) {
+		LoadModel(upload_queue.front());
+		upload_queue.erase(upload_queue.begin());
+		uploaded++;
+	}
+	return GetPendingCount();
+}
+
+ModelAsset const& ModelCache::GetAsset(uint asset) { return assets[asset]; }
+Model* ModelCache::GetModel(uint asset) { return asset < assets.size() ? assets[asset].model : nullptr; }
+
+uint ModelCache::GetPendingCount(void)
+{
+	uint pending = 0;
+	for (uint i = 0; i < assets.size(); i++) {
+		if (assets[i].state == ModelAssetState_Reading || assets[i].state == ModelAssetState_Uploading) pending++;
+	}
+	return pending;
+}
+
+uint ModelCache::GetSize(void) { return assets.size(); }
+#pragma endregion
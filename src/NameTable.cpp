@@ -0,0 +1,67 @@
+/*
+* Implementation of the interned name table.
+*/
+#include "headers/NameTable.h"
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void NameTable::Release(void)
+{
+	names.clear();
+	name_symbols.clear();
+}
+
+void NameTable::Init(void) { }
+
+NameTable::NameTable(void) { Init(); }
+
+NameTable::NameTable(NameTable const& other)
+{
+	names = other.names;
+	name_symbols = other.name_symbols;
+}
+
+NameTable& NameTable::operator=(NameTable const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		NameTable temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+NameTable::~NameTable() { Release(); }
+
+void NameTable::Swap(NameTable& other)
+{
+	std::swap(names, other.names);
+	std::swap(name_symbols, other.name_symbols);
+}
+#pragma endregion
+
+#pragma region Names
+// Symbol for a name, adding the name the first time it is seen.
+uint NameTable::Intern(String name)
+{
+	auto symbol = name_symbols.find(name);
+	if (symbol != name_symbols.end()) return symbol->second;
+
+	names.push_back(name);
+	name_symbols[name] = names.size() - 1;
+	return names.size() - 1;
+}
+
+// Symbol for a name, or -1 if the name was never interned.
+int NameTable::Find(String name)
+{
+	auto symbol = name_symbols.find(name);
+	return symbol == name_symbols.end() ? -1 : (int)symbol->second;
+}
+
+String NameTable::GetName(uint symbol) { return symbol < names.size() ? names[symbol] : ""; }
+uint NameTable::GetSize(void) { return names.size(); }
+#pragma endregion
@@ -0,0 +1,597 @@
+/*
+* Implementation of the navigation mesh. Rectangles are grown greedily over the walkable tiles and only the rectangles
+* around a changed tile are rebuilt when an obstacle is added or removed.
+*/
+#include "headers/NavigationMesh.h"
+#include <cfloat>
+#include <queue>
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void NavigationMesh::Release(void)
+{
+	walkable.clear();
+	tile_rectangle.clear();
+	rectangles.clear();
+	free_rectangles.clear();
+}
+
+void NavigationMesh::Init(void)
+{
+	grid_width = 0;
+	grid_height = 0;
+	agent_radius = 0.25f;
+	Release();
+}
+
+NavigationMesh::NavigationMesh(int width, int height)
+{
+	Init();
+	grid_width = width;
+	grid_height = height;
+	walkable.assign(width * height, true);
+	Build();
+}
+
+NavigationMesh::NavigationMesh(NavigationMesh const& other)
+{
+	grid_width = other.grid_width;
+	grid_height = other.grid_height;
+	agent_radius = other.agent_radius;
+	walkable = other.walkable;
+	tile_rectangle = other.tile_rectangle;
+	rectangles = other.rectangles;
+	free_rectangles = other.free_rectangles;
+}
+
+NavigationMesh& NavigationMesh::operator=(NavigationMesh const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		NavigationMesh temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+NavigationMesh::~NavigationMesh() { Release(); }
+
+void NavigationMesh::Swap(NavigationMesh& other)
+{
+	std::swap(grid_width, other.grid_width);
+	std::swap(grid_height, other.grid_height);
+	std::swap(agent_radius, other.agent_radius);
+	std::swap(walkable, other.walkable);
+	std::swap(tile_rectangle, other.tile_rectangle);
+	std::swap(rectangles, other.rectangles);
+	std::swap(free_rectangles, other.free_rectangles);
+}
+#pragma endregion
+
+#pragma region Mesh
+void NavigationMesh::Build(void)
+{
+	rectangles.clear();
+	free_rectangles.clear();
+	tile_rectangle.assign(grid_width * grid_height, -1);
+
+	std::vector<int> created;
+	CoverRegion(0, 0, grid_width - 1, grid_height - 1, created);
+
+	for (uint i = 0; i < created.size(); i++) {
+		LinkPortals(created[i], created);
+	}
+}
+
+void NavigationMesh::SetWalkable(int x, int z, bool is_walkable)
+{
+	TileChange change;
+	change.x = x;
+	change.z = z;
+	change.walkable = is_walkable;
+	SetWalkable(std::vector<TileChange>(1, change));
+}
+
+// Flip a set of tiles and rebuild only the rectangles they touch, all in one pass. An opened tile also pulls in its
+// neighbours so it can be merged into them instead of ending up as a rectangle of its own.
+void NavigationMesh::SetWalkable(std::vector<TileChange> const& changes)
+{
+	std::vector<int> affected;
+	int minX = grid_width, minZ = grid_height, maxX = -1, maxZ = -1;
+
+	for (uint i = 0; i < changes.size(); i++) {
+		int x = changes[i].x;
+		int z = changes[i].z;
+		if (x < 0 || z < 0 || x >= grid_width || z >= grid_height) continue;
+
+		int index = z * grid_width + x;
+		if (walkable[index] == changes[i].walkable) continue;
+		walkable[index] = changes[i].walkable;
+
+		minX = glm::min(minX, x);
+		minZ = glm::min(minZ, z);
+		maxX = glm::max(maxX, x);
+		maxZ = glm::max(maxZ, z);
+
+		int touched[5] = { tile_rectangle[index], -1, -1, -1, -1 };
+		if (changes[i].walkable) {
+			touched[1] = GetRectangleAt(x - 1, z);
+			touched[2] = GetRectangleAt(x + 1, z);
+			touched[3] = GetRectangleAt(x, z - 1);
+			touched[4] = GetRectangleAt(x, z + 1);
+		}
+
+		for (uint j = 0; j < 5; j++) {
+			if (touched[j] == -1) continue;
+			if (std::find(affected.begin(), affected.end(), touched[j]) != affected.end()) continue;
+			affected.push_back(touched[j]);
+		}
+	}
+
+	if (maxX == -1) {
+		return;
+	}
+
+	// Free up the whole area covered by the touched rectangles, then cover it again.
+	for (uint i = 0; i < affected.size(); i++) {
+		Rectangle& rectangle = rectangles[affected[i]];
+		minX = glm::min(minX, rectangle.min_x);
+		minZ = glm::min(minZ, rectangle.min_z);
+		maxX = glm::max(maxX, rectangle.max_x);
+		maxZ = glm::max(maxZ, rectangle.max_z);
+		RemoveRectangle(affected[i]);
+	}
+
+	std::vector<int> created;
+	CoverRegion(minX, minZ, maxX, maxZ, created);
+
+	for (uint i = 0; i < created.size(); i++) {
+		LinkPortals(created[i], created);
+	}
+}
+
+bool NavigationMesh::GetWalkable(int x, int z)
+{
+	if (x < 0 || z < 0 || x >= grid_width || z >= grid_height) {
+		return false;
+	}
+	return walkable[z * grid_width + x];
+}
+
+int NavigationMesh::GetRectangleAt(int x, int z)
+{
+	if (x < 0 || z < 0 || x >= grid_width || z >= grid_height) {
+		return -1;
+	}
+	return tile_rectangle[z * grid_width + x];
+}
+
+uint NavigationMesh::GetRectangleCount(void) { return rectangles.size() - free_rectangles.size(); }
+void NavigationMesh::SetAgentRadius(float radius) { agent_radius = radius; }
+#pragma endregion
+
+#pragma region Mesh Building
+bool NavigationMesh::IsFree(int x, int z)
+{
+	int index = z * grid_width + x;
+	return walkable[index] && tile_rectangle[index] == -1;
+}
+
+int NavigationMesh::CreateRectangle(int min_x, int min_z, int max_x, int max_z)
+{
+	int rectangleId = rectangles.size();
+	if (free_rectangles.size() > 0) {
+		rectangleId = free_rectangles.back();
+		free_rectangles.pop_back();
+	} else {
+		rectangles.push_back(Rectangle());
+	}
+
+	Rectangle& rectangle = rectangles[rectangleId];
+	rectangle.min_x = min_x;
+	rectangle.min_z = min_z;
+	rectangle.max_x = max_x;
+	rectangle.max_z = max_z;
+	rectangle.alive = true;
+	rectangle.portals.clear();
+
+	for (int z = min_z; z <= max_z; z++) {
+		for (int x = min_x; x <= max_x; x++) {
+			tile_rectangle[z * grid_width + x] = rectangleId;
+		}
+	}
+
+	return rectangleId;
+}
+
+void NavigationMesh::RemoveRectangle(int rectangle_id)
+{
+	Rectangle& rectangle = rectangles[rectangle_id];
+
+	// Unhook the portals that lead back into this rectangle.
+	for (uint i = 0; i < rectangle.portals.size(); i++) {
+		std::vector<Portal>& neighborPortals = rectangles[rectangle.portals[i].neighbor].portals;
+		for (uint j = 0; j < neighborPortals.size(); j++) {
+			if (neighborPortals[j].neighbor == rectangle_id) {
+				neighborPortals.erase(neighborPortals.begin() + j);
+				break;
+			}
+		}
+	}
+
+	for (int z = rectangle.min_z; z <= rectangle.max_z; z++) {
+		for (int x = rectangle.min_x; x <= rectangle.max_x; x++) {
+			int index = z * grid_width + x;
+			if (tile_rectangle[index] == rectangle_id) tile_rectangle[index] = -1;
+		}
+	}
+
+	rectangle.portals.clear();
+	rectangle.alive = false;
+	free_rectangles.push_back(rectangle_id);
+}
+
+// Greedily grow rectangles over the free walkable tiles in the region. Each rectangle grows along x as far as it can
+// and then along z while the whole row below stays free.
+void NavigationMesh::CoverRegion(int min_x, int min_z, int max_x, int max_z, std::vector<int>& created)
+{
+	min_x = glm::max(min_x, 0);
+	min_z = glm::max(min_z, 0);
+	max_x = glm::min(max_x, grid_width - 1);
+	max_z = glm::min(max_z, grid_height - 1);
+
+	for (int z = min_z; z <= max_z; z++) {
+		for (int x = min_x; x <= max_x; x++) {
+			if (!IsFree(x, z)) continue;
+
+			int endX = x;
+			while (endX + 1 <= max_x && IsFree(endX + 1, z)) endX++;
+
+			int endZ = z;
+			while (endZ + 1 <= max_z) {
+				bool rowFree = true;
+				for (int i = x; i <= endX && rowFree; i++) rowFree = IsFree(i, endZ + 1);
+				if (!rowFree) break;
+				endZ++;
+			}
+
+			created.push_back(CreateRectangle(x, z, endX, endZ));
+		}
+	}
+}
+
+// Walk the four sides of a rectangle and add a portal for every run of tiles owned by the same neighbour. Rectangles
+// created in the same pass link their own side, so we only link back to rectangles that already existed.
+void NavigationMesh::LinkPortals(int rectangle_id, std::vector<int> const& created)
+{
+	Rectangle rectangle = rectangles[rectangle_id];
+
+	for (uint side = 0; side < 4; side++) {
+		bool alongX = side >= 2;
+		int first = alongX ? rectangle.min_x : rectangle.min_z;
+		int last = alongX ? rectangle.max_x : rectangle.max_z;
+		int runStart = first;
+		int runNeighbor = -2;
+
+		for (int t = first; t <= last + 1; t++) {
+			int neighbor = -1;
+			if (t <= last) {
+				if (side == 0) neighbor = GetRectangleAt(rectangle.min_x - 1, t);
+				else if (side == 1) neighbor = GetRectangleAt(rectangle.max_x + 1, t);
+				else if (side == 2) neighbor = GetRectangleAt(t, rectangle.min_z - 1);
+				else neighbor = GetRectangleAt(t, rectangle.max_z + 1);
+			}
+
+			if (neighbor == runNeighbor) continue;
+
+			if (runNeighbor >= 0) {
+				float edge = (float)(side == 0 ? rectangle.min_x : side == 1 ? rectangle.max_x + 1 : side == 2 ? rectangle.min_z : rectangle.max_z + 1);
+				vector2 start = alongX ? vector2((float)runStart, edge) : vector2(edge, (float)runStart);
+				vector2 end = alongX ? vector2((float)t, edge) : vector2(edge, (float)t);
+				bool linkBack = std::find(created.begin(), created.end(), runNeighbor) == created.end();
+				AddPortal(rectangle_id, runNeighbor, start, end, linkBack);
+			}
+
+			runNeighbor = neighbor;
+			runStart = t;
+		}
+	}
+}
+
+void NavigationMesh::AddPortal(int from_id, int to_id, vector2 start, vector2 end, bool link_back)
+{
+	Portal portal;
+	portal.neighbor = to_id;
+	portal.start = start;
+	portal.end = end;
+	rectangles[from_id].portals.push_back(portal);
+
+	if (link_back) {
+		portal.neighbor = from_id;
+		rectangles[to_id].portals.push_back(portal);
+	}
+}
+#pragma endregion
+
+#pragma region Path Finding
+// Twice the signed area of the triangle abc. Tells us which side of the line ab the point c is on.
+float TriangleArea2(vector2 a, vector2 b, vector2 c)
+{
+	return (c.x - a.x) * (b.y - a.y) - (b.x - a.x) * (c.y - a.y);
+}
+
+bool SamePoint(vector2 a, vector2 b)
+{
+	return glm::distance(a, b) < 0.0001f;
+}
+
+// Straight line distance to the closest of the points.
+float DistanceToNearest(vector2 point, std::vector<vector2> const& points)
+{
+	float nearest = FLT_MAX;
+	for (uint i = 0; i < points.size(); i++) {
+		nearest = glm::min(nearest, glm::distance(point, points[i]));
+	}
+	return nearest;
+}
+
+bool NavigationMesh::FindPath(vector3 start, vector3 goal, std::vector<vector3>& path)
+{
+	return FindNearestPath(start, std::vector<vector3>(1, goal), path) != -1;
+}
+
+// One search towards whichever goal is the shortest walk away. Returns its index, or -1 if none can be reached.
+int NavigationMesh::FindNearestPath(vector3 start, std::vector<vector3> const& goals, std::vector<vector3>& path)
+{
+	path.clear();
+
+	vector2 start2D = vector2(start.x, start.z);
+	int startId = GetRectangleUnder(start2D);
+	if (startId == -1) {
+		return -1;
+	}
+
+	// Goals off the mesh get no rectangle and are never reached.
+	std::vector<vector2> goals2D;
+	std::vector<int> goalIds;
+	for (uint i = 0; i < goals.size(); i++) {
+		goals2D.push_back(vector2(goals[i].x, goals[i].z));
+		goalIds.push_back(GetRectangleUnder(goals2D[i]));
+	}
+
+	int goalIndex = SearchRectangles(startId, goalIds, start2D, goals2D);
+	if (goalIndex == -1) {
+		return -1;
+	}
+	int goalId = goalIds[goalIndex];
+	vector2 goal2D = goals2D[goalIndex];
+
+	std::vector<vector2> lefts;
+	std::vector<vector2> rights;
+	lefts.push_back(start2D);
+	rights.push_back(start2D);
+
+	if (startId != goalId) {
+		// Walk the rectangles back from the goal and collect the portals we crossed.
+		std::vector<int> chain;
+		for (int id = goalId; id != startId; id = search_parent[id]) {
+			chain.push_back(id);
+		}
+		std::reverse(chain.begin(), chain.end());
+
+		for (uint i = 0; i < chain.size(); i++) {
+			int fromId = search_parent[chain[i]];
+			vector2 left, right;
+			GetPortalSides(fromId, rectangles[fromId].portals[search_portal[chain[i]]], left, right);
+			lefts.push_back(left);
+			rights.push_back(right);
+		}
+	}
+
+	lefts.push_back(goal2D);
+	rights.push_back(goal2D);
+
+	std::vector<vector2> points;
+	PullString(lefts, rights, points);
+
+	// The corners the string wraps around are corners of holes. Step back from them so the agent never stands on one.
+	for (uint i = 1; i + 1 < points.size(); i++) {
+		points[i] = PushAwayFromHoles(points[i]);
+	}
+
+	for (uint i = 0; i < points.size(); i++) {
+		path.push_back(vector3(points[i].x, start.y, points[i].y));
+	}
+
+	return goalIndex;
+}
+
+// A Star over the rectangles. Each rectangle is entered through the middle of a portal and we measure the distance
+// between those entry points. Reaching a goal's rectangle queues the goal itself after the rectangles, so the first
+// goal off the list is the nearest one. Returns its index, or -1 if no goal can be reached.
+int NavigationMesh::SearchRectangles(int start_id, std::vector<int> const& goal_ids, vector2 start, std::vector<vector2> const& goals)
+{
+	uint count = rectangles.size();
+	search_g.assign(count, FLT_MAX);
+	search_parent.assign(count, -1);
+	search_portal.assign(count, -1);
+	search_point.assign(count, vector2());
+	search_closed.assign(count, false);
+
+	typedef std::pair<float, int> OpenRectangle;
+	std::priority_queue<OpenRectangle, std::vector<OpenRectangle>, std::greater<OpenRectangle>> openList;
+
+	search_g[start_id] = 0.0f;
+	search_point[start_id] = start;
+	openList.push(OpenRectangle(DistanceToNearest(start, goals), start_id));
+
+	while (!openList.empty()) {
+		int current = openList.top().second;
+		openList.pop();
+
+		if (current >= (int)count) return current - count;
+
+		if (search_closed[current]) continue;
+		search_closed[current] = true;
+
+		for (uint i = 0; i < goal_ids.size(); i++) {
+			if (goal_ids[i] == current) openList.push(OpenRectangle(search_g[current] + glm::distance(search_point[current], goals[i]), count + i));
+		}
+
+		std::vector<Portal>& portals = rectangles[current].portals;
+		for (uint i = 0; i < portals.size(); i++) {
+			int neighbor = portals[i].neighbor;
+			if (search_closed[neighbor]) continue;
+
+			vector2 entry = (portals[i].start + portals[i].end) * 0.5f;
+			float g = search_g[current] + glm::distance(search_point[current], entry);
+			if (g >= search_g[neighbor]) continue;
+
+			search_g[neighbor] = g;
+			search_parent[neighbor] = current;
+			search_portal[neighbor] = i;
+			search_point[neighbor] = entry;
+			openList.push(OpenRectangle(g + DistanceToNearest(entry, goals), neighbor));
+		}
+	}
+
+	return -1;
+}
+
+// Order the portal end points as seen when walking out of the rectangle. The portal is pulled in by the agent radius
+// so the path does not scrape the corners of the holes.
+void NavigationMesh::GetPortalSides(int from_id, Portal const& portal, vector2& left, vector2& right)
+{
+	vector2 along = portal.end - portal.start;
+	float length = glm::length(along);
+	vector2 shrink = along / length * glm::min(agent_radius, length * 0.5f);
+	vector2 start = portal.start + shrink;
+	vector2 end = portal.end - shrink;
+
+	Rectangle& from = rectangles[from_id];
+	vector2 center = vector2((from.min_x + from.max_x + 1) * 0.5f, (from.min_z + from.max_z + 1) * 0.5f);
+	vector2 middle = (start + end) * 0.5f;
+
+	if (TriangleArea2(middle, middle + (middle - center), start) > 0.0f) {
+		right = start;
+		left = end;
+	} else {
+		left = start;
+		right = end;
+	}
+}
+
+// Simple stupid funnel algorithm. Keep a funnel from the apex through the portals and add a corner every time one
+// side of the funnel crosses over the other.
+void NavigationMesh::PullString(std::vector<vector2> const& lefts, std::vector<vector2> const& rights, std::vector<vector2>& points)
+{
+	points.clear();
+
+	vector2 apex = lefts[0];
+	vector2 funnelLeft = lefts[0];
+	vector2 funnelRight = rights[0];
+	int apexIndex = 0;
+	int leftIndex = 0;
+	int rightIndex = 0;
+
+	points.push_back(apex);
+
+	for (int i = 1; i < (int)lefts.size(); i++) {
+		vector2 left = lefts[i];
+		vector2 right = rights[i];
+
+		// Tighten the right side of the funnel.
+		if (TriangleArea2(apex, funnelRight, right) <= 0.0f) {
+			if (SamePoint(apex, funnelRight) || TriangleArea2(apex, funnelLeft, right) > 0.0f) {
+				funnelRight = right;
+				rightIndex = i;
+			} else {
+				// The right side crossed the left one. The left corner is on the path.
+				apex = funnelLeft;
+				apexIndex = leftIndex;
+				points.push_back(apex);
+				funnelLeft = funnelRight = apex;
+				leftIndex = rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+
+		// Tighten the left side of the funnel.
+		if (TriangleArea2(apex, funnelLeft, left) >= 0.0f) {
+			if (SamePoint(apex, funnelLeft) || TriangleArea2(apex, funnelRight, left) < 0.0f) {
+				funnelLeft = left;
+				leftIndex = i;
+			} else {
+				// The left side crossed the right one. The right corner is on the path.
+				apex = funnelRight;
+				apexIndex = rightIndex;
+				points.push_back(apex);
+				funnelLeft = funnelRight = apex;
+				leftIndex = rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+	}
+
+	if (!SamePoint(points.back(), lefts.back())) {
+		points.push_back(lefts.back());
+	}
+}
+
+// The rectangle under a point. A point sitting on the edge of a hole floors into the hole, so we also try the tiles
+// it touches on the other side of the edge.
+int NavigationMesh::GetRectangleUnder(vector2 point)
+{
+	float epsilon = 0.001f;
+	for (int dx = 0; dx <= 2; dx++) {
+		for (int dz = 0; dz <= 2; dz++) {
+			// Try the tile under the point first, then nudge it across the edges.
+			float offsetX = (dx == 0 ? 0.0f : dx == 1 ? -epsilon : epsilon);
+			float offsetZ = (dz == 0 ? 0.0f : dz == 1 ? -epsilon : epsilon);
+			int rectangleId = GetRectangleAt((int)glm::floor(point.x + offsetX), (int)glm::floor(point.y + offsetZ));
+			if (rectangleId != -1) return rectangleId;
+		}
+	}
+	return -1;
+}
+
+// Move a point out to the agent radius from every blocked tile around it. The point is left alone if the gap is too
+// narrow to do that without landing in another hole.
+vector2 NavigationMesh::PushAwayFromHoles(vector2 point)
+{
+	// A corridor one tile wide never has more than half a tile of room on either side.
+	float clearance = glm::min(agent_radius, 0.5f);
+	int tileX = (int)glm::floor(point.x);
+	int tileZ = (int)glm::floor(point.y);
+	vector2 pushed = point;
+
+	for (int x = tileX - 1; x <= tileX + 1; x++) {
+		for (int z = tileZ - 1; z <= tileZ + 1; z++) {
+			if (GetWalkable(x, z)) continue;
+
+			vector2 closest = glm::clamp(pushed, vector2((float)x, (float)z), vector2((float)(x + 1), (float)(z + 1)));
+			vector2 away = pushed - closest;
+			float distance = glm::length(away);
+			if (distance >= clearance) continue;
+
+			if (distance < 0.0001f) {
+				// Sitting right on the hole. Step out through the side of the hole nearest to us.
+				vector2 center = vector2(x + 0.5f, z + 0.5f);
+				vector2 offset = pushed - center;
+				away = glm::abs(offset.x) >= glm::abs(offset.y) ? vector2(glm::sign(offset.x), 0.0f) : vector2(0.0f, glm::sign(offset.y));
+				pushed = closest + away * clearance;
+			} else {
+				pushed = closest + away / distance * clearance;
+			}
+		}
+	}
+
+	if (!GetWalkable((int)glm::floor(pushed.x), (int)glm::floor(pushed.y))) return point;
+	return pushed;
+}
+#pragma endregion
@@ -2,6 +2,7 @@
 * Define a rigid body which enables collision checking amongst different entities in the game world.
 */
 #include "headers/ObjectRigidBody.h"
+#include <xmmintrin.h>
 
 using namespace Simplex;
 
@@ -41,36 +42,25 @@ void ObjectRigidBody::Init(void)
 	m_CollidingArray = nullptr;
 }
 
-ObjectRigidBody::ObjectRigidBody(std::vector<vector3> point_list)
+ObjectRigidBody::ObjectRigidBody(std::vector<vector3> const& point_list)
 {
 	Init();
 
-	uint uVertexCount = point_list.size();
-
-	if (uVertexCount == 0) {
+	if (point_list.size() == 0) {
 		return;
 	}
 
-	m_v3MaxL = m_v3MinL = point_list[0];
-
-	for (uint i = 1; i < uVertexCount; ++i) {
-		if (m_v3MaxL.x < point_list[i].x) m_v3MaxL.x = point_list[i].x;
-		else if (m_v3MinL.x > point_list[i].x) m_v3MinL.x = point_list[i].x;
-
-		if (m_v3MaxL.y < point_list[i].y) m_v3MaxL.y = point_list[i].y;
-		else if (m_v3MinL.y > point_list[i].y) m_v3MinL.y = point_list[i].y;
-
-		if (m_v3MaxL.z < point_list[i].z) m_v3MaxL.z = point_list[i].z;
-		else if (m_v3MinL.z > point_list[i].z) m_v3MinL.z = point_list[i].z;
-	}
-
-	m_v3MinG = m_v3MinL;
-	m_v3MaxG = m_v3MaxL;
-
-	m_v3CenterL = (m_v3MaxL + m_v3MinL) / 2.0f;
-	m_v3HalfWidth = (m_v3MaxL - m_v3MinL) / 2.0f;
+	vector3 v3Min, v3Max;
+	ComputeLocalBounds(point_list, v3Min, v3Max);
+	SetLocalBounds(v3Min, v3Max);
+}
 
-	m_fRadius = glm::distance(m_v3CenterL, m_v3MinL);
+// Build straight from bounds worked out once per model, this is what every entity uses so none of them copies or
+// walks a vertex list.
+ObjectRigidBody::ObjectRigidBody(vector3 min_local, vector3 max_local)
+{
+	Init();
+	SetLocalBounds(min_local, max_local);
 }
 
 ObjectRigidBody::ObjectRigidBody(ObjectRigidBody const& other)
@@ -147,6 +137,69 @@ void ObjectRigidBody::Swap(ObjectRigidBody& other)
 #pragma endregion
 
 #pragma region Rigid Body Parameters
+void ObjectRigidBody::SetLocalBounds(vector3 min_local, vector3 max_local)
+{
+	m_v3MinL = min_local;
+	m_v3MaxL = max_local;
+
+	m_v3MinG = m_v3MinL;
+	m_v3MaxG = m_v3MaxL;
+
+	m_v3CenterL = (m_v3MaxL + m_v3MinL) / 2.0f;
+	m_v3HalfWidth = (m_v3MaxL - m_v3MinL) / 2.0f;
+
+	m_fRadius = glm::distance(m_v3CenterL, m_v3MinL);
+}
+
+// Min and max of a vertex list with SSE. The points are packed x y z x y z ..., so four points are exactly three
+// registers and every lane always sees the same axis of a point: the first register holds x y z x, the second y z x y
+// and the third z x y z. The lanes are folded back into one x, y and z at the end.
+void ObjectRigidBody::ComputeLocalBounds(std::vector<vector3> const& point_list, vector3& min_local, vector3& max_local)
+{
+	static_assert(sizeof(vector3) == 3 * sizeof(float), "vector3 must be three packed floats");
+
+	uint uCount = point_list.size();
+	if (uCount == 0) {
+		min_local = max_local = ZERO_V3;
+		return;
+	}
+
+	vector3 v3First = point_list[0];
+	__m128 v4Min[3] = {
+		_mm_setr_ps(v3First.x, v3First.y, v3First.z, v3First.x),
+		_mm_setr_ps(v3First.y, v3First.z, v3First.x, v3First.y),
+		_mm_setr_ps(v3First.z, v3First.x, v3First.y, v3First.z) };
+	__m128 v4Max[3] = { v4Min[0], v4Min[1], v4Min[2] };
+
+	const float* fValues = &point_list[0].x;
+	uint uBlocks = uCount / 4;
+	for (uint uBlock = 0; uBlock < uBlocks; ++uBlock) {
+		for (uint uLane = 0; uLane < 3; ++uLane) {
+			__m128 v4Values = _mm_loadu_ps(fValues + uBlock * 12 + uLane * 4);
+			v4Min[uLane] = _mm_min_ps(v4Min[uLane], v4Values);
+			v4Max[uLane] = _mm_max_ps(v4Max[uLane], v4Values);
+		}
+	}
+
+	float fMin[12], fMax[12];
+	for (uint uLane = 0; uLane < 3; ++uLane) {
+		_mm_storeu_ps(fMin + uLane * 4, v4Min[uLane]);
+		_mm_storeu_ps(fMax + uLane * 4, v4Max[uLane]);
+	}
+
+	// Lane i of the flattened registers holds axis i % 3.
+	min_local = max_local = v3First;
+	for (uint i = 0; i < 12; ++i) {
+		min_local[i % 3] = glm::min(min_local[i % 3], fMin[i]);
+		max_local[i % 3] = glm::max(max_local[i % 3], fMax[i]);
+	}
+
+	for (uint i = uBlocks * 4; i < uCount; ++i) {
+		min_local = glm::min(min_local, point_list[i]);
+		max_local = glm::max(max_local, point_list[i]);
+	}
+}
+
 bool ObjectRigidBody::GetVisibleBS(void) { return m_bVisibleBS; }
 void ObjectRigidBody::SetVisibleBS(bool visible) { m_bVisibleBS = visible; }
 bool ObjectRigidBody::GetVisibleOBB(void) { return m_bVisibleOBB; }
@@ -321,17 +374,21 @@ void ObjectRigidBody::SetModelMatrix(matrix4 model_matrix)
 	//get the new max and min for the global box
 	for (uint i = 1; i < 8; ++i)
 	{
-		if (m_v3MaxG.x < v3Corner[i].x) m_v3MaxG.x = v3Corner[i].x;
-		else if (m_v3MinG.x > v3Corner[i].x) m_v3MinG.x = v3Corner[i].x;
-
-		if (m_v3MaxG.y < v3Corner[i].y) m_v3MaxG.y = v3Corner[i].y;
-		else if (m_v3MinG.y > v3Corner[i].y) m_v3MinG.y = v3Corner[i].y;
-
-		if (m_v3MaxG.z < v3Corner[i].z) m_v3MaxG.z = v3Corner[i].z;
-		else if (m_v3MinG.z > v3Corner[i].z) m_v3MinG.z = v3Corner[i].z;
+		m_v3MinG = glm::min(m_v3MinG, v3Corner[i]);
+		m_v3MaxG = glm::max(m_v3MaxG, v3Corner[i]);
 	}
 
 	//we calculate the distance between min and max vectors
 	m_v3ARBBSize = m_v3MaxG - m_v3MinG;
 }
+
+// Take a world box someone already worked out for this matrix, so nothing is placed or compared again.
+void ObjectRigidBody::SetModelMatrix(matrix4 model_matrix, vector3 min_global, vector3 max_global)
+{
+	world_matrix = model_matrix;
+	m_v3MinG = min_global;
+	m_v3MaxG = max_global;
+	m_v3CenterG = (m_v3MinG + m_v3MaxG) / 2.0f;
+	m_v3ARBBSize = m_v3MaxG - m_v3MinG;
+}
 #pragma endregion
\ No newline at end of file
@@ -0,0 +1,258 @@
+/*
+* Implementation of the path follower.
+*/
+#include "headers/PathFollower.h"
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void PathFollower::Release(void)
+{
+	follower_paths.clear();
+	path_heights.clear();
+	cursors.clear();
+	from_points.clear();
+	to_points.clear();
+	positions.clear();
+	timers.clear();
+	travel_times.clear();
+	headings.clear();
+	moving.clear();
+	moved.clear();
+}
+
+void PathFollower::Init(void)
+{
+	seconds_per_unit = 0.6f;
+	line_of_sight = nullptr;
+}
+
+PathFollower::PathFollower(float seconds_per_unit)
+{
+	Init();
+	this->seconds_per_unit = seconds_per_unit;
+}
+
+PathFollower::PathFollower(PathFollower const& other)
+{
+	seconds_per_unit = other.seconds_per_unit;
+	line_of_sight = other.line_of_sight;
+	follower_paths = other.follower_paths;
+	path_heights = other.path_heights;
+	cursors = other.cursors;
+	from_points = other.from_points;
+	to_points = other.to_points;
+	positions = other.positions;
+	timers = other.timers;
+	travel_times = other.travel_times;
+	headings = other.headings;
+	moving = other.moving;
+	moved = other.moved;
+}
+
+PathFollower& PathFollower::operator=(PathFollower const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		PathFollower temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+PathFollower::~PathFollower() { Release(); }
+
+void PathFollower::Swap(PathFollower& other)
+{
+	std::swap(seconds_per_unit, other.seconds_per_unit);
+	std::swap(line_of_sight, other.line_of_sight);
+	std::swap(follower_paths, other.follower_paths);
+	std::swap(path_heights, other.path_heights);
+	std::swap(cursors, other.cursors);
+	std::swap(from_points, other.from_points);
+	std::swap(to_points, other.to_points);
+	std::swap(positions, other.positions);
+	std::swap(timers, other.timers);
+	std::swap(travel_times, other.travel_times);
+	std::swap(headings, other.headings);
+	std::swap(moving, other.moving);
+	std::swap(moved, other.moved);
+}
+#pragma endregion
+
+#pragma region Following
+uint PathFollower::AddFollower(void)
+{
+	follower_paths.push_back(std::vector<vector2>());
+	path_heights.push_back(0.0f);
+	cursors.push_back(0);
+	from_points.push_back(vector2());
+	to_points.push_back(vector2());
+	positions.push_back(vector2());
+	timers.push_back(0.0f);
+	travel_times.push_back(0.0f);
+	headings.push_back(0.0f);
+	moving.push_back(false);
+	moved.push_back(false);
+	return follower_paths.size() - 1;
+}
+
+uint PathFollower::GetFollowerCount(void) { return follower_paths.size(); }
+
+// The board the followers walk on. Without it a replanned path is always joined at its first waypoint.
+void PathFollower::SetLineOfSight(GridLineOfSight* line_of_sight) { this->line_of_sight = line_of_sight; }
+
+// Hand a follower a new path. A follower that is already walking joins the new path where it is closest to it and
+// heads straight for the next waypoint from there, so it never walks back to where the path was planned from. That
+// shortcut was never searched, so it is only taken when nothing is in the way. Otherwise the follower heads for the
+// first waypoint, which is where the search started from.
+void PathFollower::SetPath(uint follower, std::vector<vector3> const& path)
+{
+	std::vector<vector2>& followerPath = follower_paths[follower];
+	followerPath.clear();
+	for (uint i = 0; i < path.size(); i++) {
+		followerPath.push_back(vector2(path[i].x, path[i].z));
+	}
+	if (!path.empty()) path_heights[follower] = path[0].y;
+
+	if (moving[follower]) {
+		cursors[follower] = 0;
+		if (followerPath.empty()) return;
+
+		uint joinIndex = FindJoinWaypoint(followerPath, positions[follower]);
+		if (!line_of_sight || !line_of_sight->HasLineOfSight(positions[follower], followerPath[joinIndex])) joinIndex = 0;
+		StartSegment(follower, positions[follower], followerPath[joinIndex]);
+		cursors[follower] = joinIndex + 1;
+		timers[follower] = 0.0f;
+		return;
+	}
+
+	cursors[follower] = 0;
+	if (followerPath.size() < 2) return;
+
+	StartSegment(follower, followerPath[0], followerPath[1]);
+	cursors[follower] = 2;
+	timers[follower] = 0.0f;
+	positions[follower] = followerPath[0];
+	moving[follower] = true;
+}
+
+// Drop the path and stand still, the next path starts from its own first waypoint.
+void PathFollower::Stop(uint follower)
+{
+	follower_paths[follower].clear();
+	cursors[follower] = 0;
+	timers[follower] = 0.0f;
+	moving[follower] = false;
+}
+
+// Move every follower along its path. Time left over at the end of a segment carries into the next one.
+void PathFollower::Update(float delta)
+{
+	uint followerCount = follower_paths.size();
+	for (uint i = 0; i < followerCount; i++) Advance(i, delta);
+}
+
+// Move every follower by its own step, a follower given no time this frame stays put. Followers ticked less often
+// catch up in one go since a long step just walks through several segments.
+void PathFollower::Update(std::vector<float> const& deltas)
+{
+	uint followerCount = follower_paths.size();
+	for (uint i = 0; i < followerCount; i++) {
+		if (i < deltas.size() && deltas[i] > 0.0f) Advance(i, deltas[i]);
+		else moved[i] = false;
+	}
+}
+
+void PathFollower::Advance(uint follower, float delta)
+{
+	moved[follower] = moving[follower];
+	if (!moving[follower]) return;
+
+	timers[follower] += delta;
+	while (timers[follower] >= travel_times[follower]) {
+		timers[follower] -= travel_times[follower];
+
+		if (cursors[follower] >= follower_paths[follower].size()) {
+			timers[follower] = travel_times[follower];
+			moving[follower] = false;
+			break;
+		}
+
+		StartSegment(follower, to_points[follower], follower_paths[follower][cursors[follower]]);
+		cursors[follower]++;
+	}
+
+	positions[follower] = glm::mix(from_points[follower], to_points[follower], glm::min(timers[follower] / travel_times[follower], 1.0f));
+}
+
+// The first waypoint past a point, found by projecting the point onto the closest segment of the path.
+uint PathFollower::FindJoinWaypoint(std::vector<vector2> const& path, vector2 position)
+{
+	if (path.size() < 2) return 0;
+
+	uint joinIndex = 1;
+	float closestDistance = FLT_MAX;
+	for (uint i = 0; i + 1 < path.size(); i++) {
+		vector2 segment = path[i + 1] - path[i];
+		float segmentLength = glm::dot(segment, segment);
+		float t = segmentLength > 0.0f ? glm::clamp(glm::dot(position - path[i], segment) / segmentLength, 0.0f, 1.0f) : 1.0f;
+		float distance = glm::distance(position, path[i] + segment * t);
+		if (distance < closestDistance) {
+			closestDistance = distance;
+			joinIndex = i + 1;
+		}
+	}
+	return joinIndex;
+}
+
+// Take 0.6 seconds per tile no matter how long the segment is.
+void PathFollower::StartSegment(uint follower, vector2 from, vector2 to)
+{
+	from_points[follower] = from;
+	to_points[follower] = to;
+	travel_times[follower] = glm::max(seconds_per_unit * glm::distance(from, to), 0.01f);
+
+	// Facing +z is 0 degrees, facing +x is 90 degrees.
+	vector2 direction = to - from;
+	if (glm::length(direction) > 0.0f) headings[follower] = std::atan2(direction.x, direction.y);
+}
+#pragma endregion
+
+#pragma region Follower Queries
+bool PathFollower::IsMoving(uint follower) { return moving[follower]; }
+bool PathFollower::HasMoved(uint follower) { return moved[follower]; }
+float PathFollower::GetHeading(uint follower) { return headings[follower]; }
+
+vector3 PathFollower::GetPosition(uint follower)
+{
+	return vector3(positions[follower].x, path_heights[follower], positions[follower].y);
+}
+
+vector3 PathFollower::GetDirection(uint follower)
+{
+	vector2 direction = to_points[follower] - from_points[follower];
+	if (glm::length(direction) > 0.0f) direction = glm::normalize(direction);
+	return vector3(direction.x, 0.0f, direction.y);
+}
+
+// The path still ahead of a follower. While walking it starts where the follower is right now.
+uint PathFollower::GetRemainingCount(uint follower)
+{
+	uint pathLeft = follower_paths[follower].size() - cursors[follower];
+	return moving[follower] ? pathLeft + 2 : pathLeft;
+}
+
+vector3 PathFollower::GetRemainingWaypoint(uint follower, uint waypoint)
+{
+	vector2 point;
+	if (!moving[follower]) point = follower_paths[follower][cursors[follower] + waypoint];
+	else if (waypoint == 0) point = positions[follower];
+	else if (waypoint == 1) point = to_points[follower];
+	else point = follower_paths[follower][cursors[follower] + waypoint - 2];
+
+	return vector3(point.x, path_heights[follower], point.y);
+}
+#pragma endregion
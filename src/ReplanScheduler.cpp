@@ -0,0 +1,162 @@
+/*
+* Implementation of the replan scheduler. Keeps the number of A Star searches per frame flat no matter how many
+* seekers ask for a new path.
+*/
+#include "headers/ReplanScheduler.h"
+#include <cfloat>
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void ReplanScheduler::Release(void) { agents.clear(); }
+
+void ReplanScheduler::Init(void)
+{
+	agents.clear();
+	searches_granted = 0;
+}
+
+ReplanScheduler::ReplanScheduler(uint searches, float min_interval, float distance)
+{
+	Init();
+	searches_per_frame = searches;
+	min_replan_interval = min_interval;
+	urgency_distance = distance;
+}
+
+ReplanScheduler::ReplanScheduler(ReplanScheduler const& other)
+{
+	searches_per_frame = other.searches_per_frame;
+	min_replan_interval = other.min_replan_interval;
+	urgency_distance = other.urgency_distance;
+	agents = other.agents;
+	searches_granted = other.searches_granted;
+}
+
+ReplanScheduler& ReplanScheduler::operator=(ReplanScheduler const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		ReplanScheduler temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+ReplanScheduler::~ReplanScheduler() { Release(); }
+
+void ReplanScheduler::Swap(ReplanScheduler& other)
+{
+	std::swap(searches_per_frame, other.searches_per_frame);
+	std::swap(min_replan_interval, other.min_replan_interval);
+	std::swap(urgency_distance, other.urgency_distance);
+	std::swap(agents, other.agents);
+	std::swap(searches_granted, other.searches_granted);
+}
+#pragma endregion
+
+#pragma region Scheduling
+uint ReplanScheduler::AddAgent(void)
+{
+	agents.push_back(AgentSchedule());
+	return agents.size() - 1;
+}
+
+// Queue up a replan. Forced requests (the map changed under the path) skip the minimum interval.
+void ReplanScheduler::RequestReplan(uint agent_id, float target_distance, bool forced)
+{
+	if (agent_id >= agents.size()) {
+		return;
+	}
+
+	AgentSchedule& agent = agents[agent_id];
+	agent.pending = true;
+	agent.forced = agent.forced || forced;
+	agent.target_distance = target_distance;
+}
+
+// Advance the agent timers and hand out this frame's searches to the most urgent agents that are allowed to replan.
+void ReplanScheduler::Update(float delta)
+{
+	searches_granted = 0;
+
+	std::vector<uint> readyAgents;
+	for (uint i = 0; i < agents.size(); i++) {
+		AgentSchedule& agent = agents[i];
+		agent.time_since_replan += delta;
+		agent.granted = false;
+
+		if (!agent.pending) continue;
+		if (agent.forced || agent.time_since_replan >= GetReplanInterval(agent.target_distance)) {
+			readyAgents.push_back(i);
+		}
+	}
+
+	// Most overdue first. Agents left over stay pending and only get more overdue.
+	std::sort(readyAgents.begin(), readyAgents.end(), [this](uint a, uint b) {
+		return GetPriority(a) > GetPriority(b);
+	});
+
+	for (uint i = 0; i < readyAgents.size() && searches_granted < searches_per_frame; i++) {
+		AgentSchedule& agent = agents[readyAgents[i]];
+		agent.pending = false;
+		agent.forced = false;
+		agent.granted = true;
+		agent.time_since_replan = 0.0f;
+		searches_granted++;
+	}
+}
+
+bool ReplanScheduler::IsGranted(uint agent_id)
+{
+	if (agent_id >= agents.size()) {
+		return false;
+	}
+
+	return agents[agent_id].granted;
+}
+
+// Take one of the searches nobody asked for this frame. Used for work that is nice to have but never urgent.
+bool ReplanScheduler::UseSpareSearch(void)
+{
+	if (searches_granted >= searches_per_frame) {
+		return false;
+	}
+
+	searches_granted++;
+	return true;
+}
+
+// Far away seekers barely notice a stale path so they wait longer between searches.
+float ReplanScheduler::GetReplanInterval(float target_distance)
+{
+	return min_replan_interval * (1.0f + target_distance / urgency_distance);
+}
+
+float ReplanScheduler::GetPriority(uint agent_id)
+{
+	AgentSchedule& agent = agents[agent_id];
+	if (agent.forced) {
+		return FLT_MAX;
+	}
+
+	return agent.time_since_replan / GetReplanInterval(agent.target_distance);
+}
+#pragma endregion
+
+#pragma region Statistics
+uint ReplanScheduler::GetPendingCount(void)
+{
+	uint pending = 0;
+	for (uint i = 0; i < agents.size(); i++) {
+		if (agents[i].pending) pending++;
+	}
+	return pending;
+}
+
+uint ReplanScheduler::GetSearchesGranted(void) { return searches_granted; }
+uint ReplanScheduler::GetSearchesPerFrame(void) { return searches_per_frame; }
+void ReplanScheduler::SetSearchesPerFrame(uint searches) { searches_per_frame = searches; }
+#pragma endregion
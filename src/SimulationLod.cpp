@@ -0,0 +1,104 @@
+/*
+* Implementation of the simulation level of detail.
+*/
+#include "headers/SimulationLod.h"
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void SimulationLod::Release(void)
+{
+	levels.clear();
+	pending_time.clear();
+}
+
+void SimulationLod::Init(void)
+{
+	level_distances[0] = 20.0f;
+	level_distances[1] = 45.0f;
+	tick_intervals[SimulationLod_Full] = 0.0f;
+	tick_intervals[SimulationLod_Reduced] = 1.0f / 15.0f;
+	tick_intervals[SimulationLod_Distant] = 0.25f;
+}
+
+SimulationLod::SimulationLod(void) { Init(); }
+
+SimulationLod::SimulationLod(SimulationLod const& other)
+{
+	for (uint i = 0; i < SimulationLod_Count - 1; i++) level_distances[i] = other.level_distances[i];
+	for (uint i = 0; i < SimulationLod_Count; i++) tick_intervals[i] = other.tick_intervals[i];
+	levels = other.levels;
+	pending_time = other.pending_time;
+}
+
+SimulationLod& SimulationLod::operator=(SimulationLod const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		SimulationLod temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+SimulationLod::~SimulationLod() { Release(); }
+
+void SimulationLod::Swap(SimulationLod& other)
+{
+	for (uint i = 0; i < SimulationLod_Count - 1; i++) std::swap(level_distances[i], other.level_distances[i]);
+	for (uint i = 0; i < SimulationLod_Count; i++) std::swap(tick_intervals[i], other.tick_intervals[i]);
+	std::swap(levels, other.levels);
+	std::swap(pending_time, other.pending_time);
+}
+#pragma endregion
+
+#pragma region Level Of Detail
+uint SimulationLod::AddAgent(void)
+{
+	levels.push_back(SimulationLod_Full);
+	pending_time.push_back(0.0f);
+	return levels.size() - 1;
+}
+
+int SimulationLod::UpdateLevel(uint agent, float camera_distance)
+{
+	int level = SimulationLod_Full;
+	while (level < SimulationLod_Count - 1 && camera_distance > level_distances[level]) level++;
+
+	levels[agent] = level;
+	return level;
+}
+
+// Collect frame time until the agent's level says it is due, then hand all of it over as one step. An agent that
+// comes back to full detail gets whatever it had saved up on its very next frame.
+bool SimulationLod::Tick(uint agent, float delta, float& step)
+{
+	pending_time[agent] += delta;
+	if (pending_time[agent] < tick_intervals[levels[agent]]) {
+		step = 0.0f;
+		return false;
+	}
+
+	step = pending_time[agent];
+	pending_time[agent] = 0.0f;
+	return true;
+}
+
+int SimulationLod::GetLevel(uint agent) { return levels[agent]; }
+bool SimulationLod::ShouldCollide(uint agent) { return levels[agent] == SimulationLod_Full; }
+
+String SimulationLod::GetLevelName(int level)
+{
+	if (level == SimulationLod_Distant) return "Distant";
+	if (level == SimulationLod_Reduced) return "Reduced";
+	return "Full";
+}
+
+void SimulationLod::SetLevelDistances(float reduced_distance, float distant_distance)
+{
+	level_distances[0] = reduced_distance;
+	level_distances[1] = glm::max(distant_distance, reduced_distance);
+}
+#pragma endregion
@@ -0,0 +1,60 @@
+/*
+* Implementation of a simulation world.
+*/
+#include "headers/SimulationWorld.h"
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void SimulationWorld::Release(void)
+{
+	// The simulation still points at entities the manager owns, so it goes first.
+	SafeDelete(simulation);
+	SafeDelete(entity_manager);
+}
+
+void SimulationWorld::Init(void)
+{
+	entity_manager = nullptr;
+	simulation = nullptr;
+	seed = 0;
+}
+
+SimulationWorld::SimulationWorld(uint seed, int width, int height)
+{
+	Init();
+	this->seed = seed;
+	random_engine.seed(seed);
+	entity_manager = new GameEntityManager();
+	simulation = new AStarSimulation(this, width, height);
+}
+
+SimulationWorld::SimulationWorld(SimulationWorld const& other) { }
+SimulationWorld& SimulationWorld::operator=(SimulationWorld const& other) { return *this; }
+SimulationWorld::~SimulationWorld() { Release(); }
+#pragma endregion
+
+#pragma region World
+void SimulationWorld::Update(float delta)
+{
+	entity_manager->Update();
+	simulation->Update(delta);
+}
+
+void SimulationWorld::SetViewerPosition(vector3 position) { simulation->SetViewerPosition(position); }
+GameEntityManager* SimulationWorld::GetEntityManager(void) { return entity_manager; }
+AStarSimulation* SimulationWorld::GetSimulation(void) { return simulation; }
+#pragma endregion
+
+#pragma region Random Numbers
+uint SimulationWorld::GetSeed(void) { return seed; }
+
+// Random number in [0, range). A world seeded the same way always plays out the same game.
+uint SimulationWorld::Random(uint range)
+{
+	if (range == 0) return 0;
+	return std::uniform_int_distribution<uint>(0, range - 1)(random_engine);
+}
+
+std::mt19937& SimulationWorld::GetRandomEngine(void) { return random_engine; }
+#pragma endregion
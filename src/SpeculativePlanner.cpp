@@ -0,0 +1,140 @@
+/*
+* Implementation of the speculative planner. The planner only stores paths, the simulation runs the searches with
+* whatever search budget is left over at the end of a frame.
+*/
+#include "headers/SpeculativePlanner.h"
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void SpeculativePlanner::Release(void) { ready_paths.clear(); }
+
+void SpeculativePlanner::Init(void)
+{
+	ready_paths.clear();
+	searches = 0;
+	lookups = 0;
+	hits = 0;
+	wasted = 0;
+}
+
+SpeculativePlanner::SpeculativePlanner(uint predictions)
+{
+	Init();
+	max_predictions = predictions;
+}
+
+SpeculativePlanner::SpeculativePlanner(SpeculativePlanner const& other)
+{
+	max_predictions = other.max_predictions;
+	min_speed = other.min_speed;
+	ready_paths = other.ready_paths;
+	searches = other.searches;
+	lookups = other.lookups;
+	hits = other.hits;
+	wasted = other.wasted;
+}
+
+SpeculativePlanner& SpeculativePlanner::operator=(SpeculativePlanner const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		SpeculativePlanner temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+SpeculativePlanner::~SpeculativePlanner() { Release(); }
+
+void SpeculativePlanner::Swap(SpeculativePlanner& other)
+{
+	std::swap(max_predictions, other.max_predictions);
+	std::swap(min_speed, other.min_speed);
+	std::swap(ready_paths, other.ready_paths);
+	std::swap(searches, other.searches);
+	std::swap(lookups, other.lookups);
+	std::swap(hits, other.hits);
+	std::swap(wasted, other.wasted);
+}
+#pragma endregion
+
+#pragma region Speculation
+// Rank the four neighbouring tiles by how well they line up with the velocity. A target standing still gives no guess.
+void SpeculativePlanner::PredictNextTiles(vector3 tile_center, vector3 velocity, std::vector<vector3>& predictions)
+{
+	predictions.clear();
+
+	vector2 direction = vector2(velocity.x, velocity.z);
+	if (glm::length(direction) < min_speed) {
+		return;
+	}
+
+	vector2 offsets[4] = { vector2(1.0f, 0.0f), vector2(-1.0f, 0.0f), vector2(0.0f, 1.0f), vector2(0.0f, -1.0f) };
+	std::sort(offsets, offsets + 4, [direction](vector2 a, vector2 b) {
+		return glm::dot(a, direction) > glm::dot(b, direction);
+	});
+
+	for (uint i = 0; i < 4 && predictions.size() < max_predictions; i++) {
+		if (glm::dot(offsets[i], direction) <= 0.0f) break;
+		predictions.push_back(tile_center + vector3(offsets[i].x, 0.0f, offsets[i].y));
+	}
+}
+
+bool SpeculativePlanner::HasPath(int goal_index)
+{
+	for (uint i = 0; i < ready_paths.size(); i++) {
+		if (ready_paths[i].goal_index == goal_index) return true;
+	}
+	return false;
+}
+
+void SpeculativePlanner::StorePath(int goal_index, std::vector<vector3> const& path)
+{
+	ReadyPath readyPath;
+	readyPath.goal_index = goal_index;
+	readyPath.path = path;
+	ready_paths.push_back(readyPath);
+	searches++;
+}
+
+// Hand out a ready path to the goal. The seeker may have moved since we searched, but any part of an optimal path is
+// optimal too, so the path is still good from wherever the seeker now stands on it.
+bool SpeculativePlanner::TakePath(int goal_index, vector3 start_position, std::vector<vector3>& path)
+{
+	lookups++;
+
+	for (uint i = 0; i < ready_paths.size(); i++) {
+		if (ready_paths[i].goal_index != goal_index) continue;
+
+		std::vector<vector3>& readyPath = ready_paths[i].path;
+		for (uint j = 0; j < readyPath.size(); j++) {
+			if (readyPath[j].x == start_position.x && readyPath[j].z == start_position.z) {
+				path.assign(readyPath.begin() + j, readyPath.end());
+				ready_paths.erase(ready_paths.begin() + i);
+				hits++;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// Throw away paths that can no longer be used. Either the target moved on or the board changed under them.
+void SpeculativePlanner::DiscardPaths(void)
+{
+	wasted += ready_paths.size();
+	ready_paths.clear();
+}
+#pragma endregion
+
+#pragma region Statistics
+uint SpeculativePlanner::GetSearchCount(void) { return searches; }
+uint SpeculativePlanner::GetLookupCount(void) { return lookups; }
+uint SpeculativePlanner::GetHitCount(void) { return hits; }
+uint SpeculativePlanner::GetWastedCount(void) { return wasted; }
+float SpeculativePlanner::GetHitRate(void) { return lookups == 0 ? 0.0f : (float)hits / (float)lookups; }
+#pragma endregion
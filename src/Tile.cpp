@@ -5,17 +5,16 @@
 
 #pragma region Constructors / Destructors
 Simplex::Tile::Tile() { Init(); }
-Simplex::Tile::Tile(String entityId, vector3 entityPosition, int index) { 
+Simplex::Tile::Tile(EntityHandle entityHandle, vector3 entityPosition, int index) { 
 	Init(); 
-	entity_id = entityId;
+	entity_handle = entityHandle;
 	position = entityPosition;
 	map_index_location = index;
 }
 
 Simplex::Tile::Tile(Tile const& other)
 {
-	game_entity_manager = GameEntityManager::GetInstance();
-	entity_id = other.entity_id;
+	entity_handle = other.entity_handle;
 	active = other.active;
 	position = other.position;
 	a_star_parent = other.a_star_parent;
@@ -43,11 +42,9 @@ void Simplex::Tile::Release() { }
 
 void Simplex::Tile::Init()
 {
-	game_entity_manager = GameEntityManager::GetInstance();
-
 	a_star_parent = nullptr;
 	active = true;
-	entity_id = "None";
+	entity_handle = EntityHandle();
 	map_index_location = 0;
 	position = vector3();
 
@@ -58,8 +55,7 @@ void Simplex::Tile::Init()
 
 void Simplex::Tile::Swap(Tile& other)
 {
-	std::swap(game_entity_manager, other.game_entity_manager);
-	std::swap(entity_id, other.entity_id);
+	std::swap(entity_handle, other.entity_handle);
 	std::swap(active, other.active);
 	std::swap(position, other.position);
 	std::swap(a_star_parent, other.a_star_parent);
@@ -85,7 +81,7 @@ float Simplex::Tile::GetF(void) { return GetG() + a_star_h_value; }
 float Simplex::Tile::GetG(void) { return a_star_g_value; }
 float Simplex::Tile::GetH(void) { return a_star_h_value; }
 int Simplex::Tile::GetIndex(void) { return map_index_location; }
-Simplex::String Simplex::Tile::GetEntityId(void) { return entity_id; }
+Simplex::EntityHandle Simplex::Tile::GetEntityHandle(void) { return entity_handle; }
 Simplex::vector3 Simplex::Tile::GetPosition(void) { return position + vector3(0.5, 0.0, 0.5); } // Add on to get center.
 Simplex::Tile* Simplex::Tile::GetParent(void) { return a_star_parent; }
 #pragma endregion
@@ -0,0 +1,96 @@
+/*
+* Implementation of the tile index set.
+*/
+#include "headers/TileIndexSet.h"
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void TileIndexSet::Release(void)
+{
+	members.clear();
+	member_position.clear();
+}
+
+void TileIndexSet::Init(void)
+{
+	members.clear();
+	member_position.clear();
+}
+
+TileIndexSet::TileIndexSet(uint tile_count)
+{
+	Init();
+	members.reserve(tile_count);
+	member_position.assign(tile_count, -1);
+}
+
+TileIndexSet::TileIndexSet(TileIndexSet const& other)
+{
+	members = other.members;
+	member_position = other.member_position;
+}
+
+TileIndexSet& TileIndexSet::operator=(TileIndexSet const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		TileIndexSet temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+TileIndexSet::~TileIndexSet() { Release(); }
+
+void TileIndexSet::Swap(TileIndexSet& other)
+{
+	std::swap(members, other.members);
+	std::swap(member_position, other.member_position);
+}
+#pragma endregion
+
+#pragma region Set
+bool TileIndexSet::Insert(int tile_index)
+{
+	if (tile_index < 0 || tile_index >= member_position.size()) return false;
+	if (member_position[tile_index] != -1) return false;
+
+	member_position[tile_index] = members.size();
+	members.push_back(tile_index);
+	return true;
+}
+
+// Fill the gap with the last member instead of shifting everything after it down.
+bool TileIndexSet::Remove(int tile_index)
+{
+	if (!Contains(tile_index)) return false;
+
+	int position = member_position[tile_index];
+	int lastIndex = members.back();
+
+	members[position] = lastIndex;
+	member_position[lastIndex] = position;
+	members.pop_back();
+	member_position[tile_index] = -1;
+	return true;
+}
+
+bool TileIndexSet::Contains(int tile_index)
+{
+	if (tile_index < 0 || tile_index >= member_position.size()) return false;
+	return member_position[tile_index] != -1;
+}
+
+// Random member of the set, or -1 when it's empty.
+int TileIndexSet::Sample(std::mt19937& random_engine)
+{
+	if (members.empty()) return -1;
+	return members[std::uniform_int_distribution<uint>(0, members.size() - 1)(random_engine)];
+}
+
+int TileIndexSet::GetMember(uint position) { return members[position]; }
+uint TileIndexSet::GetSize(void) { return members.size(); }
+#pragma endregion
@@ -0,0 +1,297 @@
+/*
+* Implementation of the sparse voxel world. Chunks are looked up by a packed key and dropped again once their last
+* solid voxel is removed. A Star keeps its node data in a hash map too, so a search only pays for what it visits.
+*/
+#include "headers/VoxelNavigation.h"
+#include <algorithm>
+#include <cfloat>
+#include <queue>
+
+using namespace Simplex;
+
+#pragma region Constructors / Destructors
+void VoxelNavigation::Release(void)
+{
+	chunks.clear();
+	solid_count = 0;
+}
+
+void VoxelNavigation::Init(void)
+{
+	solid_count = 0;
+	agent_height = 2;
+	max_step_height = 1;
+	max_drop_height = 3;
+	climb_cost = 0.5f;
+}
+
+VoxelNavigation::VoxelNavigation(void) { Init(); }
+
+VoxelNavigation::VoxelNavigation(VoxelNavigation const& other)
+{
+	chunks = other.chunks;
+	solid_count = other.solid_count;
+	agent_height = other.agent_height;
+	max_step_height = other.max_step_height;
+	max_drop_height = other.max_drop_height;
+	climb_cost = other.climb_cost;
+}
+
+VoxelNavigation& VoxelNavigation::operator=(VoxelNavigation const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		VoxelNavigation temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+VoxelNavigation::~VoxelNavigation() { Release(); }
+
+void VoxelNavigation::Swap(VoxelNavigation& other)
+{
+	std::swap(chunks, other.chunks);
+	std::swap(solid_count, other.solid_count);
+	std::swap(agent_height, other.agent_height);
+	std::swap(max_step_height, other.max_step_height);
+	std::swap(max_drop_height, other.max_drop_height);
+	std::swap(climb_cost, other.climb_cost);
+}
+#pragma endregion
+
+#pragma region Voxels
+// 21 bits per axis, offset so negative coordinates pack the same way as positive ones.
+int64_t VoxelNavigation::PackKey(int x, int y, int z)
+{
+	const int64_t offset = 1 << 20;
+	const int64_t mask = (1 << 21) - 1;
+	return (((int64_t)x + offset) & mask) | ((((int64_t)y + offset) & mask) << 21) | ((((int64_t)z + offset) & mask) << 42);
+}
+
+void VoxelNavigation::UnpackKey(int64_t key, int& x, int& y, int& z)
+{
+	const int64_t offset = 1 << 20;
+	const int64_t mask = (1 << 21) - 1;
+	x = (int)((key & mask) - offset);
+	y = (int)(((key >> 21) & mask) - offset);
+	z = (int)(((key >> 42) & mask) - offset);
+}
+
+// Round towards negative infinity so voxel -1 lands in chunk -1 rather than chunk 0.
+int VoxelNavigation::FloorDivide(int value)
+{
+	return value >= 0 ? value / chunk_size : (value - chunk_size + 1) / chunk_size;
+}
+
+void VoxelNavigation::SetSolid(int x, int y, int z, bool is_solid)
+{
+	int chunkX = FloorDivide(x);
+	int chunkY = FloorDivide(y);
+	int chunkZ = FloorDivide(z);
+	int64_t chunkKey = PackKey(chunkX, chunkY, chunkZ);
+
+	std::unordered_map<int64_t, Chunk>::iterator found = chunks.find(chunkKey);
+	if (found == chunks.end()) {
+		if (!is_solid) return;
+		found = chunks.insert(std::make_pair(chunkKey, Chunk())).first;
+	}
+
+	Chunk& chunk = found->second;
+	int bit = (x - chunkX * chunk_size) + ((y - chunkY * chunk_size) + (z - chunkZ * chunk_size) * chunk_size) * chunk_size;
+	if (chunk.solid[bit] == is_solid) return;
+
+	chunk.solid[bit] = is_solid;
+	if (is_solid) {
+		chunk.solid_count++;
+		solid_count++;
+		return;
+	}
+
+	chunk.solid_count--;
+	solid_count--;
+	if (chunk.solid_count == 0) chunks.erase(found);
+}
+
+bool VoxelNavigation::IsSolid(int x, int y, int z)
+{
+	int chunkX = FloorDivide(x);
+	int chunkY = FloorDivide(y);
+	int chunkZ = FloorDivide(z);
+
+	std::unordered_map<int64_t, Chunk>::iterator found = chunks.find(PackKey(chunkX, chunkY, chunkZ));
+	if (found == chunks.end()) return false;
+
+	int bit = (x - chunkX * chunk_size) + ((y - chunkY * chunk_size) + (z - chunkZ * chunk_size) * chunk_size) * chunk_size;
+	return found->second.solid[bit];
+}
+
+// Is there room for the agent's whole height starting at this voxel.
+bool VoxelNavigation::ColumnClear(int x, int y, int z)
+{
+	for (int i = 0; i < agent_height; i++) {
+		if (IsSolid(x, y + i, z)) return false;
+	}
+	return true;
+}
+
+bool VoxelNavigation::IsStandable(int x, int y, int z) { return IsSolid(x, y - 1, z) && ColumnClear(x, y, z); }
+uint VoxelNavigation::GetSolidCount() { return solid_count; }
+uint VoxelNavigation::GetChunkCount() { return chunks.size(); }
+void VoxelNavigation::SetAgentHeight(int height) { agent_height = glm::max(height, 1); }
+
+void VoxelNavigation::SetStepHeight(int step_height, int drop_height)
+{
+	max_step_height = glm::max(step_height, 0);
+	max_drop_height = glm::max(drop_height, 0);
+}
+#pragma endregion
+
+#pragma region Path Finding
+// Every move goes one voxel sideways and pays climb_cost for each voxel it goes up or down.
+float VoxelNavigation::Heuristic(int x, int y, int z, int goal_x, int goal_y, int goal_z)
+{
+	return glm::abs(goal_x - x) + glm::abs(goal_z - z) + glm::abs(goal_y - y) * climb_cost;
+}
+
+// With several goals the nearest one is the only one that matters.
+float VoxelNavigation::Heuristic(int x, int y, int z, std::vector<glm::ivec3> const& goals)
+{
+	float nearest = FLT_MAX;
+	for (uint i = 0; i < goals.size(); i++) {
+		nearest = glm::min(nearest, Heuristic(x, y, z, goals[i].x, goals[i].y, goals[i].z));
+	}
+	return nearest;
+}
+
+bool VoxelNavigation::FindPath(vector3 start, vector3 goal, std::vector<vector3>& path)
+{
+	return FindNearestPath(start, std::vector<vector3>(1, goal), path) != -1;
+}
+
+// One search towards whichever goal is the cheapest walk away. Returns its index, or -1 if none can be reached.
+int VoxelNavigation::FindNearestPath(vector3 start, std::vector<vector3> const& goals, std::vector<vector3>& path)
+{
+	path.clear();
+
+	int startX = (int)glm::floor(start.x);
+	int startY = (int)glm::floor(start.y);
+	int startZ = (int)glm::floor(start.z);
+	if (!IsStandable(startX, startY, startZ)) {
+		return -1;
+	}
+
+	// Goals nobody can stand in are left out but keep their place in the list.
+	std::vector<glm::ivec3> goalVoxels;
+	std::vector<int> goalIndices;
+	for (uint i = 0; i < goals.size(); i++) {
+		glm::ivec3 voxel = glm::ivec3((int)glm::floor(goals[i].x), (int)glm::floor(goals[i].y), (int)glm::floor(goals[i].z));
+		if (!IsStandable(voxel.x, voxel.y, voxel.z)) continue;
+		goalVoxels.push_back(voxel);
+		goalIndices.push_back(i);
+	}
+	if (goalVoxels.empty()) {
+		return -1;
+	}
+
+	struct Node
+	{
+		float g = 0.0f;
+		int64_t parent = 0;
+		bool closed = false;
+	};
+
+	typedef std::pair<float, int64_t> OpenEntry;
+	std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+	std::unordered_map<int64_t, Node> nodes;
+
+	int64_t startKey = PackKey(startX, startY, startZ);
+	nodes[startKey].parent = startKey;
+	open.push(OpenEntry(Heuristic(startX, startY, startZ, goalVoxels), startKey));
+
+	const int offsets[4][2] = { { -1, 0 }, { 0, -1 }, { 1, 0 }, { 0, 1 } };
+	int64_t goalKey = 0;
+	int found = -1;
+
+	while (!open.empty()) {
+		int64_t currentKey = open.top().second;
+		open.pop();
+
+		Node& current = nodes[currentKey];
+		if (current.closed) continue;
+		current.closed = true;
+
+		int x, y, z;
+		UnpackKey(currentKey, x, y, z);
+
+		for (uint i = 0; i < goalVoxels.size() && found == -1; i++) {
+			if (goalVoxels[i] == glm::ivec3(x, y, z)) found = goalIndices[i];
+		}
+		if (found != -1) {
+			goalKey = currentKey;
+			break;
+		}
+		float currentG = current.g;
+
+		for (uint i = 0; i < 4; i++) {
+			int nextX = x + offsets[i][0];
+			int nextZ = z + offsets[i][1];
+			int nextY = y;
+			bool linked = false;
+
+			if (IsSolid(nextX, y, nextZ)) {
+				// Something in the way, climb it if it's low enough and we have headroom.
+				for (int step = 1; step <= max_step_height; step++) {
+					if (IsSolid(x, y + agent_height + step - 1, z)) break;
+					if (IsStandable(nextX, y + step, nextZ)) {
+						nextY = y + step;
+						linked = true;
+						break;
+					}
+				}
+			} else {
+				// Walk across, or fall down the neighbouring column until we land on something.
+				for (int drop = 0; drop <= max_drop_height; drop++) {
+					if (!ColumnClear(nextX, y - drop, nextZ)) break;
+					if (IsSolid(nextX, y - drop - 1, nextZ)) {
+						nextY = y - drop;
+						linked = true;
+						break;
+					}
+				}
+			}
+
+			if (!linked) continue;
+
+			int64_t nextKey = PackKey(nextX, nextY, nextZ);
+			float nextG = currentG + 1.0f + glm::abs(nextY - y) * climb_cost;
+
+			std::unordered_map<int64_t, Node>::iterator next = nodes.find(nextKey);
+			if (next != nodes.end() && (next->second.closed || next->second.g <= nextG)) continue;
+
+			Node& nextNode = nodes[nextKey];
+			nextNode.g = nextG;
+			nextNode.parent = currentKey;
+			open.push(OpenEntry(nextG + Heuristic(nextX, nextY, nextZ, goalVoxels), nextKey));
+		}
+	}
+
+	if (found == -1) return -1;
+
+	// Walk the parents back from the goal.
+	int64_t key = goalKey;
+	while (true) {
+		int x, y, z;
+		UnpackKey(key, x, y, z);
+		path.push_back(vector3(x + 0.5f, (float)y, z + 0.5f));
+
+		if (key == startKey) break;
+		key = nodes[key].parent;
+	}
+
+	std::reverse(path.begin(), path.end());
+	return found;
+}
+#pragma endregion
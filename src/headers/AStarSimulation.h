@@ -5,37 +5,79 @@
 */
 #pragma once
 
+#include "ClearanceMap.h"
+#include "CrowdSimulation.h"
 #include "GameEntityManager.h"
+#include "GridLineOfSight.h"
+#include "NavigationMesh.h"
+#include "PathFollower.h"
+#include "ReplanScheduler.h"
+#include "SimulationLod.h"
+#include "SpeculativePlanner.h"
 #include "Tile.h"
+#include "TileIndexSet.h"
+#include "VoxelNavigation.h"
 #include <vector>
 
 namespace Simplex
 {
+	class SimulationWorld;
+
+	enum PathfindingMode_
+	{
+		PathfindingMode_Tiles = 0,
+		PathfindingMode_AnyAngle = 1,
+		PathfindingMode_NavigationMesh = 2,
+		PathfindingMode_Voxels = 3,
+		PathfindingMode_Count = 4,
+	};
+
 	class AStarSimulation
 	{
 		public:
 		#pragma region Public Methods
-			static AStarSimulation* GetInstance();
-			static void ReleaseInstance(void);
+			AStarSimulation(SimulationWorld* world, int width = 20, int height = 20);
+			~AStarSimulation(void);
 			void Init(void);
 			void Destroy(void);
 
-			void Update(void);
+			void Update(float fDelta);
+			void SetViewerPosition(vector3 position);
 			void AddLinesToRenderList(void);
 			void AddObstacle(void);
 			void RemoveObstacle(void);
 			int GetCurrentHidden(void);
 			int GetTotalObstacleCount(void);
+			SpeculativePlanner* GetSpeculativePlanner(void);
+			NavigationMesh* GetNavigationMesh(void);
+			VoxelNavigation* GetVoxelNavigation(void);
+			GridLineOfSight* GetLineOfSight(void);
+			bool CanSeeTarget(void);
+			String GetSeekerLodName(void);
+			EntityHandle GetFinderHandle(void);
+			EntityHandle GetTargetHandle(void);
+			void NextAgentSize(void);
+			int GetAgentSize(void);
+			bool UsesClearance(void);
+			void NextPathfindingMode(void);
+			String GetPathfindingModeName(void);
 		# pragma endregion
 
 		private:
-			static AStarSimulation* instance;
-			bool recalculate_a_star = true;
-
 		#pragma region Game State
+			SimulationWorld* world = nullptr;
 			GameEntityManager* game_entity_manager = nullptr;
 			MeshManager* mesh_manager = nullptr;
-			SystemSingleton* system = nullptr;
+			ReplanScheduler* replan_scheduler = nullptr;
+			SpeculativePlanner* speculative_planner = nullptr;
+			NavigationMesh* navigation_mesh = nullptr;
+			GridLineOfSight* line_of_sight = nullptr;
+			ClearanceMap* clearance_map = nullptr;
+			VoxelNavigation* voxel_navigation = nullptr;
+			PathFollower* path_follower = nullptr;
+			CrowdSimulation* crowd = nullptr;
+			SimulationLod* simulation_lod = nullptr;
+			int pathfinding_mode = PathfindingMode_NavigationMesh;
 		#pragma endregion
 
 		#pragma region Map Data
@@ -43,14 +85,24 @@ namespace Simplex
 			int map_height;
 			int map_area;
 			int floor_level;
+			vector3 grid_origin;
+			float cell_size;
+			int agent_size;
 		#pragma endregion
 
 		#pragma region Entity State
+			EntityHandle target_handle;
+			EntityHandle finder_handle;
 			GameEntity* target;
 			GameEntity* finder;
+			uint finder_schedule_id;
+			uint finder_follower_id;
+			uint finder_crowd_id;
+			uint finder_lod_id;
+			std::vector<float> follower_steps;
 			vector3 target_last_position;
-			vector3 traveling_to;
-			vector3 traveling_from;
+			vector3 viewer_position;
+			bool has_viewer;
 		#pragma endregion
 
 		#pragma region Tile Data
@@ -61,18 +113,24 @@ namespace Simplex
 			std::vector<vector3> paths;
 			int allowed_hidden_tiles;
 			int number_tiles_hidden;
-			std::vector<Tile*> hidden_tile_list;
+			TileIndexSet free_tiles;
+			TileIndexSet hidden_tiles;
+			std::vector<std::pair<int, int>> explosion_stencil;
 		#pragma endregion
 
 		#pragma region A Star Init
-			AStarSimulation(int width, int height);
 			AStarSimulation(AStarSimulation const& other);
 			AStarSimulation& operator=(AStarSimulation const& other);
-			~AStarSimulation(void);
-			void CreateEntity(String fileName, String entityId, vector3 position);
+			EntityHandle CreateEntity(String fileName, String entityId, vector3 position);
 			Tile* RandomFreeTile(void);
 			bool NoOneStandingOnTile(Tile* tile); // Pick Locaiton / Simulation Restart
+			bool WorldToGrid(vector3 position, int& x, int& z);
 			Tile* GetClosestTile(vector3 position);
+			Tile* GetStandingTile(vector3 position);
+			void GetClosestTiles(std::vector<vector3> const& positions, std::vector<Tile*>& tiles);
+			void GetActiveTilesAround(Tile* tile, std::vector<Tile*>& tiles);
+			void GetFittingTilesOver(Tile* tile, std::vector<Tile*>& tiles);
+			bool TileFitsSeeker(Tile* tile);
 			bool PointInsideTile(vector3 position, Tile* tile);
 		#pragma endregion
 
@@ -80,20 +138,38 @@ namespace Simplex
 			void CheckIfWeNeedAStarUpdate(void);
 			bool ValidateAStarInput(Tile* startTile, Tile* endTile); // Init
 			void OverrideAStarTileCheck(void);
+			void RequestReplan(bool forced = false);
+			void ApplyTileChanges(std::vector<Tile*> const& hiddenTiles, std::vector<Tile*> const& shownTiles);
+			void SetTileWalkable(int index, bool walkable, std::vector<NavigationMesh::TileChange>& meshChanges);
+			void InvalidatePath(void);
+			bool PathBlockedBy(Tile* tile);
+			bool PathShortenedBy(Tile* tile);
+			bool TileOnRemainingPath(Tile* tile);
+			bool RemainingPathTooTight(void);
+			bool SegmentCrossesTile(vector3 from, vector3 to, Tile* tile);
+			float RemainingPathLength(void);
 		#pragma endregion
 
 		# pragma region A Star Algorithm
 			void CalculateAStarBetweenTiles(Tile* startTile, Tile* endTile);
+			bool SearchPath(Tile* startTile, Tile* endTile, std::vector<vector3>& path);
+			int SearchNearestPath(Tile* startTile, std::vector<Tile*> const& goalTiles, std::vector<vector3>& path);
 			void AStarSetup(Tile* startTile, Tile* endTile);
-			void GetPathFromTiles(Tile* startTile, Tile* endTile);
+			void AStarSetup(std::vector<Tile*> const& startTiles, Tile* endTile);
+			void GetPathFromTiles(Tile* startTile, Tile* endTile, std::vector<vector3>& path);
+			void SmoothPath(std::vector<vector3>& path);
+			float ManhattanDistance(vector3 from, vector3 to);
+			float PathDistance(vector3 from, vector3 to);
 			bool AStarAlgo(Tile* currentCell, Tile* endCell, int openIndex);
 		#pragma endregion
 
+		#pragma region Speculative Planning
+			void SpeculateTargetPaths(void);
+		#pragma endregion
+
 		#pragma region Entity Movement
+			void SteerCrowd(float fDelta);
 			void MoveSeeker(void);
-			float GetMovingDirctionRotation(void);
-			void GetNextPath(void);
-			void StartPathFindingIfNotMoving(void);
 			bool WeHavePaths(void);
 		#pragma endregion
 
@@ -101,6 +177,7 @@ namespace Simplex
 			bool CheckCollisions(void);
 			void Collide(float fDelta);
 			void RestartPathFinding(void);
+			void BuildExplosionStencil(int radius);
 			void ExploadGround(void);
 			void MoveCreeper(void);
 		#pragma endregion
@@ -7,6 +7,7 @@
 #include "./FileSystem.h"
 #include "./GameEntityManager.h"
 #include "./AStarSimulation.h"
+#include "./SimulationWorld.h"
 #include "./ImGuiObject.h"
 
 #include "Simplex\Simplex.h"
@@ -50,6 +51,7 @@ namespace Simplex
 			LightManager* light_manager = nullptr;
 			MeshManager* mesh_manager = nullptr;
 			CameraManager* camera_manager = nullptr;
+			SimulationWorld* world = nullptr;
 			AStarSimulation* a_star_simulation = nullptr;
 			GameEntityManager* entity_manager = nullptr;
 		# pragma endregion
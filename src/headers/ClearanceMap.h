@@ -0,0 +1,44 @@
+/*
+* Clearance map for agents bigger than one tile. Every tile stores the size of the largest square of walkable tiles
+* that starts on it and grows towards +x and +z, so an agent of size n fits on a tile when its clearance is at least n.
+* Values are capped at the largest agent size we care about, which keeps updates local when a tile changes.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	class ClearanceMap
+	{
+		private:
+		#pragma region Clearance Data
+			int grid_width = 0;
+			int grid_height = 0;
+			int max_clearance = 4;
+			std::vector<bool> walkable;
+			std::vector<int> clearance;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+			void UpdateTile(int x, int z);
+		public:
+
+		#pragma region Constructors / Destructors
+			ClearanceMap(int width = 0, int height = 0, int max_clearance = 4);
+			ClearanceMap(ClearanceMap const& other);
+			ClearanceMap& operator=(ClearanceMap const& other);
+			~ClearanceMap(void);
+			void Swap(ClearanceMap& other);
+		#pragma endregion
+
+		#pragma region Clearance
+			void Build(void);
+			void SetWalkable(int x, int z, bool is_walkable);
+			int GetClearance(int x, int z);
+			bool CanFit(int x, int z, int size);
+			int GetMaxClearance(void);
+		#pragma endregion
+	};
+}
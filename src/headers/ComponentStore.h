@@ -0,0 +1,130 @@
+/*
+* Component storage for the entities of one entity manager. Every entity owns one row, the row number being its slot
+* in the entity manager, and each kind of data lives in its own packed array so the systems below read memory in a
+* straight line. Every component keeps a dense list of the rows that have it, which is all a system walks over.
+*
+* A transform is kept as position, rotation and scale. Whatever moves an entity writes those and marks the row dirty,
+* the world matrix and bounds are only rebuilt the next time someone reads them, so a row that moves several times
+* in a frame pays for one matrix and a row that doesn't move pays nothing. Rows that got a new matrix are collected
+* until the owner has passed the matrices on, once per frame.
+*
+* Entities without physics are static. Entities with physics are awake until they have barely moved for a number of
+* frames, then they fall asleep and drop out of the physics pass until something pushes or moves them.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	enum Component_
+	{
+		Component_Transform = 0,
+		Component_Physics = 1,
+		Component_Collider = 2,
+		Component_Render = 3,
+		Component_Awake = 4,
+		Component_Count = 5,
+	};
+
+	enum MotionState_
+	{
+		MotionState_Static = 0,
+		MotionState_Awake = 1,
+		MotionState_Sleeping = 2,
+	};
+
+	class ComponentStore
+	{
+		private:
+		#pragma region Transform
+			std::vector<matrix4> world_matrices;
+			std::vector<vector3> positions;
+			std::vector<quaternion> rotations;
+			std::vector<vector3> sizes;
+			std::vector<bool> dirty_transforms;
+			std::vector<uint> dirty_rows;
+			std::vector<bool> moved_transforms;
+			std::vector<uint> moved_rows;
+		#pragma endregion
+
+		#pragma region Physics
+			std::vector<vector3> velocities;
+			std::vector<vector3> accelerations;
+			std::vector<float> masses;
+			std::vector<uint> still_frames;
+			float sleep_velocity = 0.01f;
+			uint sleep_frames = 30;
+		#pragma endregion
+
+		#pragma region Collider
+			std::vector<vector3> local_mins;
+			std::vector<vector3> local_maxs;
+			std::vector<vector3> aabb_mins;
+			std::vector<vector3> aabb_maxs;
+		#pragma endregion
+
+		#pragma region Membership
+			std::vector<uint> members[Component_Count];
+			std::vector<int> member_positions[Component_Count];
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+			void MarkDirty(uint row);
+			void RefreshTransform(uint row);
+		public:
+
+		#pragma region Constructors / Destructors
+			ComponentStore(void);
+			ComponentStore(ComponentStore const& other);
+			ComponentStore& operator=(ComponentStore const& other);
+			~ComponentStore(void);
+			void Swap(ComponentStore& other);
+		#pragma endregion
+
+		#pragma region Rows
+			void Reserve(uint row_capacity);
+			void ResetRow(uint row);
+			void ClearRow(uint row);
+			void AddComponent(uint row, int component);
+			void RemoveComponent(uint row, int component);
+			bool HasComponent(uint row, int component);
+			std::vector<uint> const& GetMembers(int component);
+			int GetMotionState(uint row);
+			void WakeUp(uint row);
+			void SetSleepSettings(float velocity, uint frames);
+		#pragma endregion
+
+		#pragma region Component Data
+			matrix4 GetWorldMatrix(uint row);
+			void SetWorldMatrix(uint row, matrix4 world_matrix);
+			void SetTransform(uint row, vector3 position, quaternion rotation, vector3 size);
+			vector3 GetPosition(uint row);
+			void SetPosition(uint row, vector3 position);
+			quaternion GetRotation(uint row);
+			void SetRotation(uint row, quaternion rotation);
+			vector3 GetSize(uint row);
+			vector3 GetVelocity(uint row);
+			void SetVelocity(uint row, vector3 velocity);
+			float GetMass(uint row);
+			void SetMass(uint row, float mass);
+			void ApplyForce(uint row, vector3 force);
+			void SetLocalBounds(uint row, vector3 local_min, vector3 local_max);
+			vector3 GetBoundsMin(uint row);
+			vector3 GetBoundsMax(uint row);
+		#pragma endregion
+
+		#pragma region Systems
+			void UpdateTransforms(void);
+			std::vector<uint> const& GetMovedRows(void);
+			void ClearMovedRows(void);
+			void IntegratePhysics(void);
+			void IntegratePhysics(uint row);
+			void UpdateBounds(void);
+			void UpdateBounds(uint row);
+			bool Overlaps(uint row, uint other_row);
+			void ResolveCollision(uint row, uint other_row);
+		#pragma endregion
+	};
+}
@@ -0,0 +1,83 @@
+/*
+* Crowd layer for many agents walking on the board at once. Every agent is given the velocity it would like to have
+* (usually towards the next point on its path) and the crowd bends that into a velocity that won't walk into its
+* neighbours, using ORCA (optimal reciprocal collision avoidance). Neighbours are found through a uniform spatial hash
+* rebuilt each frame, and the avoidance solve for each agent runs on worker threads.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	class CrowdSimulation
+	{
+		private:
+		#pragma region Crowd Settings
+			float neighbor_distance = 2.0f;
+			float time_horizon = 1.0f;
+			uint max_neighbors = 10;
+			uint worker_count = 1;
+		#pragma endregion
+
+		#pragma region Agent State
+			std::vector<vector2> positions;
+			std::vector<vector2> velocities;
+			std::vector<vector2> preferred_velocities;
+			std::vector<vector2> new_velocities;
+			std::vector<float> radii;
+			std::vector<float> max_speeds;
+			float time_step = 0.0f;
+		#pragma endregion
+
+		#pragma region Spatial Hash
+			uint table_size = 0;
+			std::vector<uint> agent_cells;
+			std::vector<uint> cell_starts;
+			std::vector<uint> sorted_agents;
+		#pragma endregion
+
+		#pragma region Avoidance
+			struct Line
+			{
+				vector2 point;
+				vector2 direction;
+			};
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+			uint HashCell(int x, int z);
+			void BuildSpatialHash(void);
+			void FindNeighbors(uint agent, std::vector<uint>& neighbors);
+			void ComputeNewVelocities(uint begin, uint end);
+			void ComputeNewVelocity(uint agent, std::vector<uint>& neighbors, std::vector<Line>& lines);
+			bool LinearProgram1(std::vector<Line> const& lines, uint line_number, float radius, vector2 optimal, bool direction_optimal, vector2& result);
+			uint LinearProgram2(std::vector<Line> const& lines, float radius, vector2 optimal, bool direction_optimal, vector2& result);
+			void LinearProgram3(std::vector<Line> const& lines, uint begin_line, float radius, vector2& result);
+		public:
+
+		#pragma region Constructors / Destructors
+			CrowdSimulation(float neighbor_distance = 2.0f, float time_horizon = 1.0f, uint max_neighbors = 10);
+			CrowdSimulation(CrowdSimulation const& other);
+			CrowdSimulation& operator=(CrowdSimulation const& other);
+			~CrowdSimulation(void);
+			void Swap(CrowdSimulation& other);
+		#pragma endregion
+
+		#pragma region Agents
+			uint AddAgent(vector2 position, float radius, float max_speed);
+			uint GetAgentCount(void);
+			void SetPosition(uint agent, vector2 position);
+			void SetPreferredVelocity(uint agent, vector2 velocity);
+			vector2 GetPosition(uint agent);
+			vector2 GetVelocity(uint agent);
+		#pragma endregion
+
+		#pragma region Simulation
+			void Update(float delta);
+			void SetWorkerCount(uint workers);
+			uint GetWorkerCount(void);
+		#pragma endregion
+	};
+}
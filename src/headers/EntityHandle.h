@@ -0,0 +1,31 @@
+/*
+* A handle is how the game refers to an entity. It packs the entity's slot in the entity manager into the low 22 bits
+* and the slot's generation into the high 10 bits. Removing an entity bumps its slot's generation, so a handle that
+* outlives its entity stops resolving instead of pointing at whatever reuses the slot. The all zero handle is null.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	struct EntityHandle
+	{
+		static const uint INDEX_BITS = 22;
+		static const uint INDEX_MASK = (1u << INDEX_BITS) - 1;
+		static const uint GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+		uint value = 0;
+
+		EntityHandle(void) { }
+		explicit EntityHandle(uint value) : value(value) { }
+
+		static EntityHandle Make(uint index, uint generation) { return EntityHandle((generation << INDEX_BITS) | (index & INDEX_MASK)); }
+		uint GetIndex(void) const { return value & INDEX_MASK; }
+		uint GetGeneration(void) const { return value >> INDEX_BITS; }
+		bool IsNull(void) const { return value == 0; }
+
+		bool operator==(EntityHandle const& other) const { return value == other.value; }
+		bool operator!=(EntityHandle const& other) const { return value != other.value; }
+	};
+}
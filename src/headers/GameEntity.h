@@ -4,7 +4,8 @@
 */
 #pragma once
 
-#include "ObjectPhysics.h"
+#include "ComponentStore.h"
+#include "ModelCache.h"
 #include "ObjectRigidBody.h"
 
 namespace Simplex
@@ -14,36 +15,35 @@ namespace Simplex
 		private:
 		#pragma region Game Parameters
 			String id = "";
-			static std::map<String, GameEntity*> id_to_entity;
 			bool entity_model_loaded_in_memory = false;
 		#pragma endregion
 
 		#pragma region Physics
 			uint exists_in_dimensions_count = 0;
 			uint* dimensions_lives_in = nullptr;
-			bool should_use_physics = false;
-			bool is_rigid_body_disabled = false;
 		#pragma endregion
 
 		#pragma region Rendering
 			bool should_render_axis = false;
-			matrix4 world_matrix = IDENTITY_M4;
 			bool is_model_rendering_disabled = false;
 		#pragma endregion
 
 		#pragma region Model Attributes
-			Model* model = nullptr;
+			ModelCache* model_cache = nullptr;
+			uint model_asset = 0;
 			ObjectRigidBody* rigid_body = nullptr;
 			MeshManager* mesh_manager = nullptr;
-			ObjectPhysics* physics = nullptr;
+			ComponentStore* components = nullptr;
+			uint component_row = 0;
 		#pragma endregion
 
 			void Release(void);
 			void Init(void);
+			void UpdateRenderComponent(void);
 		public:
 
 		#pragma region Constructor / Destructor
-			GameEntity(String model_file, String unique_id = "NA");
+			GameEntity(ModelCache* model_cache, uint model_asset, String unique_id, ComponentStore* components, uint component_row);
 			GameEntity(GameEntity const& other);
 			GameEntity& operator=(GameEntity const& other);
 			~GameEntity(void);
@@ -52,10 +52,8 @@ namespace Simplex
 		#pragma endregion
 
 		#pragma region Game State	
-			void Update(void);
-			static GameEntity* GetEntity(String unique_id);
-			void GenUniqueID(String& unique_id);
 			String GetUniqueID(void);
+			uint GetComponentRow(void);
 		#pragma endregion
 
 		#pragma region Collision
@@ -80,8 +78,9 @@ namespace Simplex
 			vector3 GetVelocity(void);
 			void SetMass(float mass);
 			float GetMass(void);
-			ObjectPhysics* GetSolver(void);
 			void UsePhysics(bool use_physics = true);
+			int GetMotionState(void);
+			void WakeUp(void);
 			ObjectRigidBody* GetRigidBody(void);
 			void DisableRigidBody(void);
 			bool HasThisRigidBody(ObjectRigidBody* rigid_body);
@@ -91,7 +90,10 @@ namespace Simplex
 			Model* GetModel(void);
 			matrix4 GetModelMatrix(void);
 			void SetModelMatrix(matrix4 set_world_matrix);
+			void SetTransform(vector3 position, quaternion rotation = quaternion(), vector3 scale = vector3(1.0f));
+			void RefreshModelMatrix(void);
 			void AddToRenderList(bool draw_rigid_body = false);
+			void AddRigidBodyToRenderList(void);
 			void SetAxisVisible(bool set_axis_enabled = true);
 			void HideModelRender(void);
 			void ShowModelRender(void);
@@ -3,39 +3,60 @@
 */
 #pragma once
 
+#include "EntityHandle.h"
 #include "GameEntity.h"
+#include "ModelCache.h"
+#include "NameTable.h"
 
 namespace Simplex
 {
 	class GameEntityManager
 	{
 		private: 
-			uint entity_count = 0;
-			GameEntity** entities = nullptr;
-			static GameEntityManager* instance;
+			std::vector<GameEntity*> entities;
+			std::vector<uint> entity_slots;
+			std::vector<uint> slot_entities;
+			std::vector<uint> slot_generations;
+			std::vector<uint> free_slots;
+			NameTable entity_names;
+			ComponentStore components;
+			ModelCache model_cache;
+			std::vector<EntityHandle> named_handles;
+			uint unique_id_suffix = 0;
 
-			GameEntityManager(void);
 			GameEntityManager(GameEntityManager const& other);
 			GameEntityManager& operator=(GameEntityManager const& other);
-			~GameEntityManager(void);
 			void Release(void);
 			void Init(void);
+			void GenUniqueID(String& entity_id);
 		public:
 		
 		#pragma region Constructor / Destructor
-			static GameEntityManager* GetInstance();
-			static void ReleaseInstance(void);
+			GameEntityManager(void);
+			~GameEntityManager(void);
 		#pragma endregion
 		
 		#pragma region Game State
 			int GetEntityIndex(String entity_id);
-			void AddEntity(String model_file_name, String entity_id = "NA");
+			int GetEntityIndex(EntityHandle handle);
+			void Reserve(uint entity_capacity);
+			void PrefetchModels(std::vector<String> const& model_file_names);
+			uint UploadModels(uint upload_budget = 1);
+			EntityHandle AddEntity(String model_file_name, String entity_id = "NA");
+			void AddEntities(String model_file_name, std::vector<String> const& entity_ids, std::vector<EntityHandle>& added_handles);
 			void RemoveEntity(uint entity_index);
 			void RemoveEntity(String entity_id);
+			void RemoveEntity(EntityHandle handle);
+			bool IsValid(EntityHandle handle);
+			EntityHandle GetHandle(uint entity_index);
+			EntityHandle GetHandle(String entity_id);
 			String GetUniqueID(uint entity_index = -1);
 			uint GetEntityCount(void);
 			GameEntity* GetEntity(uint entity_index = -1);
+			GameEntity* GetEntity(String entity_id);
+			GameEntity* GetEntity(EntityHandle handle);
 			void Update(void);
+			void UpdateTransforms(void);
 		#pragma endregion
 
 		#pragma region Collision
@@ -58,6 +79,7 @@ namespace Simplex
 		#pragma region Physics
 			void ApplyForce(vector3 force, String entity_id);
 			void ApplyForce(vector3 force, uint entity_index = -1);
+			void ApplyForce(vector3 force, EntityHandle handle);
 			void SetPosition(vector3 position, String entity_id);
 			void SetPosition(vector3 position, uint entity_index = -1);
 			void SetMass(float mass, String entity_id);
@@ -73,8 +95,12 @@ namespace Simplex
 			matrix4 GetModelMatrix(String entity_id);
 			void SetModelMatrix(matrix4 world_matrix, uint entity_index = -1);
 			void SetModelMatrix(matrix4 world_matrix, String entity_id);
+			void SetModelMatrix(matrix4 world_matrix, EntityHandle handle);
+			void SetTransform(vector3 position, quaternion rotation, EntityHandle handle);
 			void HideModelRender(String entity_id);
 			void ShowModelRender(String entity_id);
+			void HideModelRender(EntityHandle handle);
+			void ShowModelRender(EntityHandle handle);
 			void SetAxisVisibility(bool axis_visibility, uint entity_index = -1);
 			void SetAxisVisibility(bool axis_visibility, String entity_id);
 			void AddEntityToRenderList(uint entity_index = -1, bool rigid_body = false);
@@ -0,0 +1,48 @@
+/*
+* Line of sight queries over a bitmap of walkable tiles. A line is clear when every tile it passes through is walkable.
+* Passing exactly through a corner also needs both tiles beside the corner to be clear, so an agent never squeezes
+* diagonally between two holes. Used to smooth paths and for AI visibility checks. Works in the same grid space as
+* the navigation mesh where tile (x, z) covers [x, x + 1] by [z, z + 1].
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+#include <cstdint>
+
+namespace Simplex
+{
+	class GridLineOfSight
+	{
+		private:
+		#pragma region Bitmap
+			int grid_width = 0;
+			int grid_height = 0;
+			int words_per_row = 0;
+			std::vector<uint64_t> walkable_bits;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+			bool RowClear(int z, int min_x, int max_x);
+			bool TraverseLine(vector2 from, vector2 to);
+		public:
+
+		#pragma region Constructors / Destructors
+			GridLineOfSight(int width = 0, int height = 0);
+			GridLineOfSight(GridLineOfSight const& other);
+			GridLineOfSight& operator=(GridLineOfSight const& other);
+			~GridLineOfSight(void);
+			void Swap(GridLineOfSight& other);
+		#pragma endregion
+
+		#pragma region Bitmap
+			void SetWalkable(int x, int z, bool is_walkable);
+			bool GetWalkable(int x, int z);
+		#pragma endregion
+
+		#pragma region Queries
+			bool HasLineOfSight(vector2 from, vector2 to);
+			void HasLineOfSight(std::vector<vector2> const& from, std::vector<vector2> const& to, std::vector<char>& visible);
+		#pragma endregion
+	};
+}
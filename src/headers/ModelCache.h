@@ -0,0 +1,85 @@
+/*
+* Models shared between entities. Each file is loaded once and its local bounding box worked out once, every entity
+* made from that file then refers to the same model and only keeps its own transform.
+*
+* Loading happens in two halves. The file is read and its bounds worked out on a worker thread as soon as it is asked
+* for, that is all an entity needs to be created and to collide. The model itself has to go to the GPU, so it is
+* loaded later on the render thread a few files per frame, entities made from it draw nothing until then.
+*
+* The first time an OBJ file is loaded it is also cooked into a binary BTO file named after a hash of the OBJ's
+* contents, next to it goes a small bounds file. Later runs load the BTO and read the bounds without parsing any text.
+* Editing the OBJ changes its hash, so a stale cook is simply never looked at again.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+#include <future>
+#include <unordered_map>
+
+namespace Simplex
+{
+	enum ModelAssetState_
+	{
+		ModelAssetState_Reading = 0,
+		ModelAssetState_Uploading = 1,
+		ModelAssetState_Ready = 2,
+		ModelAssetState_Failed = 3,
+	};
+
+	struct ModelBounds
+	{
+		bool read = false;
+		bool cooked = false;
+		String cooked_name = "";
+		unsigned long long content_hash = 0;
+		vector3 local_min = ZERO_V3;
+		vector3 local_max = ZERO_V3;
+	};
+
+	struct ModelAsset
+	{
+		String file_name = "";
+		Model* model = nullptr;
+		vector3 local_min = ZERO_V3;
+		vector3 local_max = ZERO_V3;
+		String cooked_name = "";
+		unsigned long long content_hash = 0;
+		bool cooked = false;
+		int state = ModelAssetState_Reading;
+		std::shared_future<ModelBounds> bounds_task;
+	};
+
+	class ModelCache
+	{
+		private:
+			std::vector<ModelAsset> assets;
+			std::unordered_map<String, uint> asset_lookup;
+			std::vector<uint> upload_queue;
+
+			void Release(void);
+			void Init(void);
+			void FinishReading(uint asset);
+			bool LoadModel(uint asset);
+			void CookModel(uint asset);
+		public:
+
+		#pragma region Constructors / Destructors
+			ModelCache(void);
+			ModelCache(ModelCache const& other);
+			ModelCache& operator=(ModelCache const& other);
+			~ModelCache(void);
+			void Swap(ModelCache& other);
+		#pragma endregion
+
+		#pragma region Assets
+			uint Request(String file_name);
+			void Prefetch(std::vector<String> const& file_names);
+			int Acquire(String file_name);
+			uint Upload(uint upload_budget);
+			ModelAsset const& GetAsset(uint asset);
+			Model* GetModel(uint asset);
+			uint GetPendingCount(void);
+			uint GetSize(void);
+		#pragma endregion
+	};
+}
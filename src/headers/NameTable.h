@@ -0,0 +1,37 @@
+/*
+* Interned strings. Each distinct name is stored once and given a small number (its symbol) that never changes, so
+* anything that needs a name can keep the symbol and compare numbers instead of strings.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+#include <unordered_map>
+
+namespace Simplex
+{
+	class NameTable
+	{
+		private:
+			std::vector<String> names;
+			std::unordered_map<String, uint> name_symbols;
+
+			void Release(void);
+			void Init(void);
+		public:
+
+		#pragma region Constructors / Destructors
+			NameTable(void);
+			NameTable(NameTable const& other);
+			NameTable& operator=(NameTable const& other);
+			~NameTable(void);
+			void Swap(NameTable& other);
+		#pragma endregion
+
+		#pragma region Names
+			uint Intern(String name);
+			int Find(String name);
+			String GetName(uint symbol);
+			uint GetSize(void);
+		#pragma endregion
+	};
+}
@@ -0,0 +1,103 @@
+/*
+* A navigation mesh built on top of the tile grid. Walkable tiles are merged into rectangles and neighbouring
+* rectangles are linked through portals (the edge they share). A Star then searches a handful of rectangles instead of
+* every tile, and a funnel pass pulls the path tight through the portals. The mesh works in grid space where tile
+* (x, z) covers [x, x + 1] by [z, z + 1].
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	class NavigationMesh
+	{
+		public:
+			struct TileChange
+			{
+				int x = 0;
+				int z = 0;
+				bool walkable = true;
+			};
+
+		private:
+		#pragma region Mesh Data
+			struct Portal
+			{
+				int neighbor = -1;
+				vector2 start;
+				vector2 end;
+			};
+
+			struct Rectangle
+			{
+				int min_x = 0;
+				int min_z = 0;
+				int max_x = 0;
+				int max_z = 0;
+				bool alive = false;
+				std::vector<Portal> portals;
+			};
+
+			int grid_width = 0;
+			int grid_height = 0;
+			float agent_radius = 0.25f;
+			std::vector<bool> walkable;
+			std::vector<int> tile_rectangle;
+			std::vector<Rectangle> rectangles;
+			std::vector<int> free_rectangles;
+		#pragma endregion
+
+		#pragma region Search Data
+			std::vector<float> search_g;
+			std::vector<int> search_parent;
+			std::vector<int> search_portal;
+			std::vector<vector2> search_point;
+			std::vector<bool> search_closed;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+
+		#pragma region Mesh Building
+			bool IsFree(int x, int z);
+			int CreateRectangle(int min_x, int min_z, int max_x, int max_z);
+			void RemoveRectangle(int rectangle_id);
+			void CoverRegion(int min_x, int min_z, int max_x, int max_z, std::vector<int>& created);
+			void LinkPortals(int rectangle_id, std::vector<int> const& created);
+			void AddPortal(int from_id, int to_id, vector2 start, vector2 end, bool link_back);
+		#pragma endregion
+
+		#pragma region Path Finding
+			int SearchRectangles(int start_id, std::vector<int> const& goal_ids, vector2 start, std::vector<vector2> const& goals);
+			void GetPortalSides(int from_id, Portal const& portal, vector2& left, vector2& right);
+			void PullString(std::vector<vector2> const& lefts, std::vector<vector2> const& rights, std::vector<vector2>& points);
+			int GetRectangleUnder(vector2 point);
+			vector2 PushAwayFromHoles(vector2 point);
+		#pragma endregion
+		public:
+
+		#pragma region Constructors / Destructors
+			NavigationMesh(int width = 0, int height = 0);
+			NavigationMesh(NavigationMesh const& other);
+			NavigationMesh& operator=(NavigationMesh const& other);
+			~NavigationMesh(void);
+			void Swap(NavigationMesh& other);
+		#pragma endregion
+
+		#pragma region Mesh
+			void Build(void);
+			void SetWalkable(int x, int z, bool is_walkable);
+			void SetWalkable(std::vector<TileChange> const& changes);
+			bool GetWalkable(int x, int z);
+			int GetRectangleAt(int x, int z);
+			uint GetRectangleCount(void);
+			void SetAgentRadius(float radius);
+		#pragma endregion
+
+		#pragma region Path Finding
+			bool FindPath(vector3 start, vector3 goal, std::vector<vector3>& path);
+			int FindNearestPath(vector3 start, std::vector<vector3> const& goals, std::vector<vector3>& path);
+		#pragma endregion
+	};
+}
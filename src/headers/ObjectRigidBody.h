@@ -41,7 +41,8 @@ namespace Simplex
 
 		public:
 		#pragma region Constructors / Destructors
-			ObjectRigidBody(std::vector<vector3> point_list);
+			ObjectRigidBody(std::vector<vector3> const& point_list);
+			ObjectRigidBody(vector3 min_local, vector3 max_local);
 			ObjectRigidBody(ObjectRigidBody const& other);
 			ObjectRigidBody& operator=(ObjectRigidBody const& other);
 			~ObjectRigidBody(void);
@@ -49,6 +50,7 @@ namespace Simplex
 		#pragma endregion
 
 		#pragma region Rigid Body Parameters
+			static void ComputeLocalBounds(std::vector<vector3> const& point_list, vector3& min_local, vector3& max_local);
 			bool GetVisibleBS(void);
 			void SetVisibleBS(bool visible);
 			bool GetVisibleOBB(void);
@@ -83,10 +85,12 @@ namespace Simplex
 			void AddToRenderList(void);
 			matrix4 GetModelMatrix(void);
 			void SetModelMatrix(matrix4 model_matrix);
+			void SetModelMatrix(matrix4 model_matrix, vector3 min_global, vector3 max_global);
 		#pragma endregion
 		
 		private:
 			void Release(void);
 			void Init(void);
+			void SetLocalBounds(vector3 min_local, vector3 max_local);
 	};
 }
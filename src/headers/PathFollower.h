@@ -0,0 +1,70 @@
+/*
+* Path following for any number of agents. Each follower owns its path as x / z points plus one height, a cursor to
+* the next waypoint and a timer for the segment it is walking, so consuming a waypoint never moves the rest of the
+* path. The per follower state is kept in flat arrays and Update advances every follower in one loop.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+#include "GridLineOfSight.h"
+
+namespace Simplex
+{
+	class PathFollower
+	{
+		private:
+		#pragma region Follower Settings
+			float seconds_per_unit = 0.6f;
+			GridLineOfSight* line_of_sight = nullptr;
+		#pragma endregion
+
+		#pragma region Follower State
+			std::vector<std::vector<vector2>> follower_paths;
+			std::vector<float> path_heights;
+			std::vector<uint> cursors;
+			std::vector<vector2> from_points;
+			std::vector<vector2> to_points;
+			std::vector<vector2> positions;
+			std::vector<float> timers;
+			std::vector<float> travel_times;
+			std::vector<float> headings;
+			std::vector<char> moving;
+			std::vector<char> moved;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+			void Advance(uint follower, float delta);
+			void StartSegment(uint follower, vector2 from, vector2 to);
+			uint FindJoinWaypoint(std::vector<vector2> const& path, vector2 position);
+		public:
+
+		#pragma region Constructors / Destructors
+			PathFollower(float seconds_per_unit = 0.6f);
+			PathFollower(PathFollower const& other);
+			PathFollower& operator=(PathFollower const& other);
+			~PathFollower(void);
+			void Swap(PathFollower& other);
+		#pragma endregion
+
+		#pragma region Following
+			uint AddFollower(void);
+			uint GetFollowerCount(void);
+			void SetLineOfSight(GridLineOfSight* line_of_sight);
+			void SetPath(uint follower, std::vector<vector3> const& path);
+			void Stop(uint follower);
+			void Update(float delta);
+			void Update(std::vector<float> const& deltas);
+		#pragma endregion
+
+		#pragma region Follower Queries
+			bool IsMoving(uint follower);
+			bool HasMoved(uint follower);
+			vector3 GetPosition(uint follower);
+			vector3 GetDirection(uint follower);
+			float GetHeading(uint follower);
+			uint GetRemainingCount(uint follower);
+			vector3 GetRemainingWaypoint(uint follower, uint waypoint);
+		#pragma endregion
+	};
+}
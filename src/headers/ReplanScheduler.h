@@ -0,0 +1,64 @@
+/*
+* The replan scheduler owns every decision about when a seeker may run A Star. Seekers post replan requests, the
+* scheduler holds them back until a minimum interval has passed (longer for seekers far away from their target) and
+* only grants a fixed number of searches each frame. Requests that miss out stay queued for the next frame.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	class ReplanScheduler
+	{
+		private:
+		#pragma region Scheduler Settings
+			uint searches_per_frame = 4;
+			float min_replan_interval = 0.25f;
+			float urgency_distance = 10.0f;
+		#pragma endregion
+
+		#pragma region Agent State
+			struct AgentSchedule
+			{
+				float time_since_replan = 0.0f;
+				float target_distance = 0.0f;
+				bool pending = false;
+				bool forced = false;
+				bool granted = false;
+			};
+
+			std::vector<AgentSchedule> agents;
+			uint searches_granted = 0;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+			float GetPriority(uint agent_id);
+		public:
+
+		#pragma region Constructors / Destructors
+			ReplanScheduler(uint searches_per_frame = 4, float min_replan_interval = 0.25f, float urgency_distance = 10.0f);
+			ReplanScheduler(ReplanScheduler const& other);
+			ReplanScheduler& operator=(ReplanScheduler const& other);
+			~ReplanScheduler(void);
+			void Swap(ReplanScheduler& other);
+		#pragma endregion
+
+		#pragma region Scheduling
+			uint AddAgent(void);
+			void RequestReplan(uint agent_id, float target_distance, bool forced = false);
+			void Update(float delta);
+			bool IsGranted(uint agent_id);
+			bool UseSpareSearch(void);
+			float GetReplanInterval(float target_distance);
+		#pragma endregion
+
+		#pragma region Statistics
+			uint GetPendingCount(void);
+			uint GetSearchesGranted(void);
+			uint GetSearchesPerFrame(void);
+			void SetSearchesPerFrame(uint searches);
+		#pragma endregion
+	};
+}
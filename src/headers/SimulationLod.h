@@ -0,0 +1,55 @@
+/*
+* Simulation level of detail. Agents far from the camera are ticked less often and catch up by the whole time they
+* skipped in one step, they also don't get collision checks or new model matrices on the frames they sit out. Only
+* agents at full detail are simulated every frame.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	enum SimulationLod_
+	{
+		SimulationLod_Full = 0,
+		SimulationLod_Reduced = 1,
+		SimulationLod_Distant = 2,
+		SimulationLod_Count = 3,
+	};
+
+	class SimulationLod
+	{
+		private:
+		#pragma region Level Settings
+			float level_distances[SimulationLod_Count - 1] = { 20.0f, 45.0f };
+			float tick_intervals[SimulationLod_Count] = { 0.0f, 1.0f / 15.0f, 0.25f };
+		#pragma endregion
+
+		#pragma region Agent State
+			std::vector<int> levels;
+			std::vector<float> pending_time;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+		public:
+
+		#pragma region Constructors / Destructors
+			SimulationLod(void);
+			SimulationLod(SimulationLod const& other);
+			SimulationLod& operator=(SimulationLod const& other);
+			~SimulationLod(void);
+			void Swap(SimulationLod& other);
+		#pragma endregion
+
+		#pragma region Level Of Detail
+			uint AddAgent(void);
+			int UpdateLevel(uint agent, float camera_distance);
+			bool Tick(uint agent, float delta, float& step);
+			int GetLevel(uint agent);
+			bool ShouldCollide(uint agent);
+			String GetLevelName(int level);
+			void SetLevelDistances(float reduced_distance, float distant_distance);
+		#pragma endregion
+	};
+}
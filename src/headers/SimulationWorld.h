@@ -0,0 +1,47 @@
+/*
+* A simulation world owns everything one game of the simulation needs: its entities, its board of tiles and its random
+* numbers. Nothing in a world is shared through singletons, so many worlds can live side by side and be updated on
+* different threads, for example to play out hundreds of seeded games at once.
+*/
+#pragma once
+
+#include "AStarSimulation.h"
+#include "GameEntityManager.h"
+
+namespace Simplex
+{
+	class SimulationWorld
+	{
+		private:
+		#pragma region World State
+			GameEntityManager* entity_manager = nullptr;
+			AStarSimulation* simulation = nullptr;
+			std::mt19937 random_engine;
+			uint seed = 0;
+		#pragma endregion
+
+			SimulationWorld(SimulationWorld const& other);
+			SimulationWorld& operator=(SimulationWorld const& other);
+			void Release(void);
+			void Init(void);
+		public:
+
+		#pragma region Constructors / Destructors
+			SimulationWorld(uint seed, int width = 20, int height = 20);
+			~SimulationWorld(void);
+		#pragma endregion
+
+		#pragma region World
+			void Update(float delta);
+			void SetViewerPosition(vector3 position);
+			GameEntityManager* GetEntityManager(void);
+			AStarSimulation* GetSimulation(void);
+		#pragma endregion
+
+		#pragma region Random Numbers
+			uint GetSeed(void);
+			uint Random(uint range);
+			std::mt19937& GetRandomEngine(void);
+		#pragma endregion
+	};
+}
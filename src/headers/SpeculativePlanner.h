@@ -0,0 +1,65 @@
+/*
+* The speculative planner guesses which tile the target will step onto next from its velocity and keeps paths to
+* those tiles ready. When the target really crosses into a predicted tile the ready path is swapped in and the search
+* is skipped. We also track how often the guess pays off so we can tell if the extra searches are worth it.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	class SpeculativePlanner
+	{
+		private:
+		#pragma region Prediction Settings
+			uint max_predictions = 2;
+			float min_speed = 0.01f;
+		#pragma endregion
+
+		#pragma region Ready Paths
+			struct ReadyPath
+			{
+				int goal_index = -1;
+				std::vector<vector3> path;
+			};
+
+			std::vector<ReadyPath> ready_paths;
+		#pragma endregion
+
+		#pragma region Statistics
+			uint searches = 0;
+			uint lookups = 0;
+			uint hits = 0;
+			uint wasted = 0;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+		public:
+
+		#pragma region Constructors / Destructors
+			SpeculativePlanner(uint max_predictions = 2);
+			SpeculativePlanner(SpeculativePlanner const& other);
+			SpeculativePlanner& operator=(SpeculativePlanner const& other);
+			~SpeculativePlanner(void);
+			void Swap(SpeculativePlanner& other);
+		#pragma endregion
+
+		#pragma region Speculation
+			void PredictNextTiles(vector3 tile_center, vector3 velocity, std::vector<vector3>& predictions);
+			bool HasPath(int goal_index);
+			void StorePath(int goal_index, std::vector<vector3> const& path);
+			bool TakePath(int goal_index, vector3 start_position, std::vector<vector3>& path);
+			void DiscardPaths(void);
+		#pragma endregion
+
+		#pragma region Statistics
+			uint GetSearchCount(void);
+			uint GetLookupCount(void);
+			uint GetHitCount(void);
+			uint GetWastedCount(void);
+			float GetHitRate(void);
+		#pragma endregion
+	};
+}
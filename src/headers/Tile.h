@@ -11,8 +11,7 @@ namespace Simplex
     {
         private: 
         #pragma region Game State Data
-            GameEntityManager* game_entity_manager;
-            String entity_id;
+            EntityHandle entity_handle;
             vector3 position;
             int map_index_location;
             bool active;
@@ -28,7 +27,7 @@ namespace Simplex
         public: 
         #pragma region Constructors / Destructors
             Tile();
-            Tile(String entityId, vector3 position, int index);
+            Tile(EntityHandle entityHandle, vector3 position, int index);
 			Tile(Tile const& other);
 			Tile& operator=(Tile const& other);
 			~Tile(void);
@@ -44,7 +43,7 @@ namespace Simplex
             float GetH(void);
             int GetIndex(void);
             bool GetActive(void);
-            String GetEntityId(void);
+            EntityHandle GetEntityHandle(void);
             Tile* GetParent(void);
             vector3 GetPosition(void);
         #pragma endregion
@@ -0,0 +1,41 @@
+/*
+* A set of tile indices that can insert, remove and pick a random member in constant time. Members are packed into a
+* dense array and every tile remembers where it sits in that array, so a removal just moves the last member into the
+* gap.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+
+namespace Simplex
+{
+	class TileIndexSet
+	{
+		private:
+		#pragma region Set Data
+			std::vector<int> members;
+			std::vector<int> member_position;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+		public:
+
+		#pragma region Constructors / Destructors
+			TileIndexSet(uint tile_count = 0);
+			TileIndexSet(TileIndexSet const& other);
+			TileIndexSet& operator=(TileIndexSet const& other);
+			~TileIndexSet(void);
+			void Swap(TileIndexSet& other);
+		#pragma endregion
+
+		#pragma region Set
+			bool Insert(int tile_index);
+			bool Remove(int tile_index);
+			bool Contains(int tile_index);
+			int Sample(std::mt19937& random_engine);
+			int GetMember(uint position);
+			uint GetSize(void);
+		#pragma endregion
+	};
+}
@@ -0,0 +1,72 @@
+/*
+* Sparse voxel world for navigating more than one floor. Solid voxels are kept in 8x8x8 chunks that only exist while
+* they hold something, so empty air costs nothing. An agent stands in an empty voxel with a solid one under it and
+* can walk to a neighbour, climb a ramp or ledge of max_step_height, or drop down up to max_drop_height. Positions
+* passed in and out are the voxel the agent stands in, with x and z at the voxel center.
+*/
+#pragma once
+
+#include "Simplex/Simplex.h"
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Simplex
+{
+	class VoxelNavigation
+	{
+		private:
+		#pragma region Voxel Data
+			static const int chunk_size = 8;
+
+			struct Chunk
+			{
+				std::bitset<chunk_size * chunk_size * chunk_size> solid;
+				uint solid_count = 0;
+			};
+
+			std::unordered_map<int64_t, Chunk> chunks;
+			uint solid_count = 0;
+		#pragma endregion
+
+		#pragma region Agent Settings
+			int agent_height = 2;
+			int max_step_height = 1;
+			int max_drop_height = 3;
+			float climb_cost = 0.5f;
+		#pragma endregion
+
+			void Release(void);
+			void Init(void);
+			int64_t PackKey(int x, int y, int z);
+			void UnpackKey(int64_t key, int& x, int& y, int& z);
+			int FloorDivide(int value);
+			bool ColumnClear(int x, int y, int z);
+			float Heuristic(int x, int y, int z, int goal_x, int goal_y, int goal_z);
+			float Heuristic(int x, int y, int z, std::vector<glm::ivec3> const& goals);
+		public:
+
+		#pragma region Constructors / Destructors
+			VoxelNavigation(void);
+			VoxelNavigation(VoxelNavigation const& other);
+			VoxelNavigation& operator=(VoxelNavigation const& other);
+			~VoxelNavigation(void);
+			void Swap(VoxelNavigation& other);
+		#pragma endregion
+
+		#pragma region Voxels
+			void SetSolid(int x, int y, int z, bool is_solid);
+			bool IsSolid(int x, int y, int z);
+			bool IsStandable(int x, int y, int z);
+			uint GetSolidCount(void);
+			uint GetChunkCount(void);
+			void SetAgentHeight(int height);
+			void SetStepHeight(int step_height, int drop_height);
+		#pragma endregion
+
+		#pragma region Path Finding
+			bool FindPath(vector3 start, vector3 goal, std::vector<vector3>& path);
+			int FindNearestPath(vector3 start, std::vector<vector3> const& goals, std::vector<vector3>& path);
+		#pragma endregion
+	};
+}